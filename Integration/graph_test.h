@@ -0,0 +1,97 @@
+/* ----------------------------------------------------------------------
+ * Project:      NanoGraph
+ * Title:        graph_test.h
+ * Description:  entry points of the test harness
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+ /*
+  * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+  *
+  * SPDX-License-Identifier: Apache-2.0
+  *
+  * Licensed under the Apache License, Version 2.0 (the License); you may
+  * not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+#ifndef cGRAPH_TEST_H
+#define cGRAPH_TEST_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* synthetic graph of graph_test_arcs.c, for the host tests of the arcs and of the IO acknowledges */
+#if defined(BENCHMARK_ARC_ACCESS) || defined(STRESS_ARC_SPSC) || defined(TEST_ARC_HISTORY) || \
+    defined(STRESS_DMA_PINGPONG) || defined(BENCHMARK_IO_ACK_POST) || defined(TEST_DRIFT_HOUR) || \
+    defined(TEST_SHM_IO) || defined(TEST_IO_CONVERSION) || defined(TEST_ARC_PLANAR) || \
+    defined(TEST_2D_BANDS) || defined(TEST_IO_COALESCING)
+#define GRAPH_TEST_ARCS
+extern nanograph_instance_t *graph_test_enter(void);
+extern void graph_test_leave(void);
+extern void graph_test_arc(uint32_t iarc, uint32_t size, uint32_t frame_size, uint32_t fmt1);
+extern void graph_test_io(uint32_t io, uint32_t iarc, uint8_t tx, uint32_t iofmt1);
+#endif
+
+/* IO patterns of the systick, graph_test_scheduler.c */
+extern void graph_test_scheduler(uint64_t time64);
+#ifdef VIRTUAL_TIME
+extern float graph_test_virtual_time(void);
+#endif
+
+/* benchmarks and stress tests, called once by main_init() after the reset of the graph */
+#ifdef BENCHMARK_DF1_Q15
+extern void graph_test_benchmark_df1_q15(void);
+#endif
+#ifdef TEST_BIQUAD_F32
+extern uint32_t graph_test_biquad_f32(void);
+#endif
+#ifdef BENCHMARK_ARC_ACCESS
+extern void graph_test_benchmark_arc_access(void);
+#endif
+#ifdef STRESS_ARC_SPSC
+extern void graph_test_stress_arc_spsc(void);
+#endif
+#ifdef TEST_ARC_HISTORY
+extern uint32_t graph_test_arc_history(void);
+#endif
+#ifdef STRESS_DMA_PINGPONG
+extern uint32_t graph_test_stress_dma_pingpong(void);
+#endif
+#if defined(BENCHMARK_IO_ACK_POST) && defined(IO_ACK_QUEUE)
+extern void graph_test_benchmark_io_ack_post(void);
+#endif
+#if defined(TEST_DRIFT_HOUR) && defined(IO_DRIFT_COMPENSATION)
+extern uint32_t graph_test_drift_hour(void);
+#endif
+#if defined(TEST_SHM_IO) && defined(PLATFORM_SHM_IO)
+extern uint32_t graph_test_shm_io(void);
+#endif
+#if defined(TEST_IO_CONVERSION) && defined(IO_FORMAT_CONVERSION)
+extern uint32_t graph_test_io_conversion(void);
+#endif
+#if defined(TEST_ARC_PLANAR) && defined(ARC_PLANAR)
+extern uint32_t graph_test_arc_planar(void);
+#endif
+#ifdef TEST_2D_BANDS
+extern uint32_t graph_test_2d_bands(void);
+#endif
+#if defined(TEST_IO_COALESCING) && defined(IO_COALESCING)
+extern uint32_t graph_test_io_coalescing(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* #ifndef cGRAPH_TEST_H */
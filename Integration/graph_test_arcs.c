@@ -0,0 +1,852 @@
+/* ----------------------------------------------------------------------
+ * Project:      NanoGraph
+ * Title:        graph_test_arcs.c
+ * Description:  host tests and benchmarks of the arcs and of the IO acknowledges
+ *
+ * $Date:        15 February 2023
+ * $Revision:    V0.0.1
+ * -------------------------------------------------------------------- */
+ /*
+  * Copyright (C) 2010-2023 ARM Limited or its affiliates. All rights reserved.
+  *
+  * SPDX-License-Identifier: Apache-2.0
+  *
+  * Licensed under the Apache License, Version 2.0 (the License); you may
+  * not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+  * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+
+
+#include "../top_manifest_included.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include "../nanograph_common.h"
+#include "../nanograph_interpreter.h"
+#include "graph_test.h"
+
+#ifdef GRAPH_TEST_ARCS
+/*
+    test graph : TEST_NB_ARCS arcs and TEST_NB_IOS IOs in a private instance, the IO "io" has the
+    platform index "io" and the graph index "io". The instance replaces the one of the application
+    for NanoGraph_io_ack() between graph_test_enter() and graph_test_leave().
+*/
+#define TEST_NB_ARCS    4
+#define TEST_NB_IOS     MAX_NBGRAPHIO
+#define TEST_ARC_BYTES  1024
+
+static nanograph_instance_t test_instance;
+static nanograph_instance_t *test_saved_instance;
+static uintptr_t test_saved_ptr;
+
+static uint32_t test_arcs[SIZEOF_ARCDESC_W32 * TEST_NB_ARCS];
+static uint32_t test_formats[NANOGRAPH_FORMAT_SIZE_W32 * TEST_NB_ARCS];
+static uint32_t test_pio_hw[TRANSLATE_PLATFORM_HWIO_AL_IDX_SIZE_W32 * TEST_NB_IOS];
+static uint32_t test_pio_graph[NANOGRAPH_IOFMT_SIZE_W32 * TEST_NB_IOS];
+static uintptr_t test_arc_base[TEST_NB_ARCS];
+static uint32_t test_flow_errors[SIZEOF_FLOWCNT_W32 * TEST_NB_ARCS];
+static uint32_t test_buffers[TEST_NB_ARCS][TEST_ARC_BYTES / 4];
+static uint8_t *test_long_offset[MAX_PROC_MEMBANK];       /* in-place IOs, BASE_ARCW0 is packed with lin2pack() */
+#ifdef ARC_HOT_COLD_SPLIT
+static uint32_t test_arc_hot[SIZEOF_ARCHOT_W32 * TEST_NB_ARCS];
+#endif
+#ifdef ARC_WATERMARKS
+static uint32_t test_watermarks[TEST_NB_ARCS];
+#endif
+#ifdef ARC_EXTENDED
+static uint32_t test_arc_extended[SIZEOF_ARCEXT_W32 * TEST_NB_ARCS];
+#endif
+#ifdef IO_DRIFT_COMPENSATION
+static uint32_t test_arc_drift[SIZEOF_ARCDRIFT_W32 * TEST_NB_ARCS];
+#endif
+#ifdef IO_COALESCING
+static uint32_t test_arc_staging[SIZEOF_ARCSTG_W32 * TEST_NB_ARCS];
+#endif
+
+
+/**
+  @brief        arc of the test graph
+  @param[in]    iarc        index of the arc, and of the format of its producer and consumer
+  @param[in]    size        buffer size in bytes, at most TEST_ARC_BYTES
+  @param[in]    frame_size  frame size of the producer and of the consumer
+  @param[in]    fmt1        word FMT1 of the format (raw type, interleaving, nb channels)
+  @return       none
+ */
+void graph_test_arc (uint32_t iarc, uint32_t size, uint32_t frame_size, uint32_t fmt1)
+{
+    uint32_t *arc = &(test_arcs[SIZEOF_ARCDESC_W32 * iarc]);
+
+    MEMSET(arc, 0, 4 * SIZEOF_ARCDESC_W32)
+    ST(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1, size);
+    ST(arc[FMT_ARCW4], CONSUMFMT_ARCW4, iarc);
+    ST(arc[FMT_ARCW4], PRODUCFMT_ARCW4, iarc);
+
+    MEMSET(&(test_formats[NANOGRAPH_FORMAT_SIZE_W32 * iarc]), 0, 4 * NANOGRAPH_FORMAT_SIZE_W32)
+    ST(test_formats[NANOGRAPH_FORMAT_SIZE_W32 * iarc], FRAMESIZE_FMT0, frame_size);
+    test_formats[NANOGRAPH_FORMAT_SIZE_W32 * iarc + NCHANDOMAIN_FMT1] = fmt1;
+
+    test_arc_base[iarc] = (uintptr_t)(test_buffers[iarc]);
+    test_flow_errors[SIZEOF_FLOWCNT_W32 * iarc + OVERFLOW_FLOWCNT] = 0;
+    test_flow_errors[SIZEOF_FLOWCNT_W32 * iarc + UNDERFLOW_FLOWCNT] = 0;
+#ifdef ARC_WATERMARKS
+    test_watermarks[iarc] = 0;
+#endif
+#ifdef IO_DRIFT_COMPENSATION
+    MEMSET(&(test_arc_drift[SIZEOF_ARCDRIFT_W32 * iarc]), 0, 4 * SIZEOF_ARCDRIFT_W32)
+    test_arc_drift[SIZEOF_ARCDRIFT_W32 * iarc + STEP_DRIFT] = DRIFT_UNITY;
+#endif
+#ifdef IO_COALESCING
+    MEMSET(&(test_arc_staging[SIZEOF_ARCSTG_W32 * iarc]), 0, 4 * SIZEOF_ARCSTG_W32)
+#endif
+#ifdef ARC_HOT_COLD_SPLIT
+    test_arc_hot[SIZEOF_ARCHOT_W32 * iarc + CTRL_HOTW0] = 0;
+    test_arc_hot[SIZEOF_ARCHOT_W32 * iarc + RD_HOTW1] = arc[RD_ARCW2];
+    test_arc_hot[SIZEOF_ARCHOT_W32 * iarc + WR_HOTW2] = arc[WR_ARCW3];
+#endif
+}
+
+
+/**
+  @brief        commander IO of the test graph, copying its frames to/from an arc
+  @param[in]    io          platform and graph index of the IO
+  @param[in]    iarc        arc of the IO
+  @param[in]    tx          0 : RX to the graph, 1 : TX from the graph
+  @param[in]    iofmt1      word IOFMT1 of the IO (IORAW_IOFMT1, DRIFTCOMP_IOFMT1, ..)
+  @return       none
+ */
+void graph_test_io (uint32_t io, uint32_t iarc, uint8_t tx, uint32_t iofmt1)
+{
+    uint32_t *pio = &(test_pio_graph[NANOGRAPH_IOFMT_SIZE_W32 * io]);
+
+    test_pio_hw[TRANSLATE_PLATFORM_HWIO_AL_IDX_SIZE_W32 * io] = 0;
+    ST(test_pio_hw[TRANSLATE_PLATFORM_HWIO_AL_IDX_SIZE_W32 * io], IDX_TO_NANOGRAPH_HWIO_CONTROL, io);
+
+    MEMSET(pio, 0, 4 * NANOGRAPH_IOFMT_SIZE_W32)
+    ST(pio[0], IOARCID_IOFMT0, iarc);
+    ST(pio[0], RX0TX1_IOFMT0, tx);
+    ST(pio[0], SET0COPY1_IOFMT0, IO_COMMAND_DATA_COPY);
+    pio[IOFMT1] = iofmt1;
+}
+
+
+/**
+  @brief        the test graph replaces the instance of the application for the IO acknowledges
+  @return       the test instance
+ */
+nanograph_instance_t *graph_test_enter (void)
+{
+    extern nanograph_instance_t *platform_io_callback_parameter;
+    extern uintptr_t all_ptr_instances[];
+    nanograph_instance_t *S = &test_instance;
+
+    MEMSET(S, 0, sizeof(nanograph_instance_t))
+    S->all_arcs = test_arcs;
+    S->all_formats = test_formats;
+    S->pio_hw = test_pio_hw;
+    S->pio_graph = test_pio_graph;
+    S->nb_graph_io = TEST_NB_IOS;
+    S->arc_base = test_arc_base;
+    S->arc_flow_errors = test_flow_errors;
+    S->long_offset = test_long_offset;
+#ifdef ARC_HOT_COLD_SPLIT
+    S->arc_hot = test_arc_hot;
+#endif
+#ifdef ARC_WATERMARKS
+    S->arc_watermarks = test_watermarks;
+#endif
+#ifdef ARC_EXTENDED
+    S->arc_extended = test_arc_extended;
+#endif
+#ifdef IO_DRIFT_COMPENSATION
+    S->arc_drift = test_arc_drift;
+#endif
+#ifdef IO_COALESCING
+    S->arc_staging = test_arc_staging;
+#endif
+
+    test_saved_instance = platform_io_callback_parameter;
+    test_saved_ptr = all_ptr_instances[0];
+    platform_io_callback_parameter = S;
+    all_ptr_instances[0] = (uintptr_t)S;
+    return S;
+}
+
+/**
+  @brief        restores the instance of the application
+  @return       none
+ */
+void graph_test_leave (void)
+{
+    extern nanograph_instance_t *platform_io_callback_parameter;
+    extern uintptr_t all_ptr_instances[];
+
+    platform_io_callback_parameter = test_saved_instance;
+    all_ptr_instances[0] = test_saved_ptr;
+}
+#endif
+
+
+#ifdef BENCHMARK_ARC_ACCESS
+#include <stdio.h>
+#include <time.h>
+
+extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+
+#define BENCHMARK_ARC_FRAME 64
+#define BENCHMARK_ARC_LOOPS 1000000
+#define BENCHMARK_ARC_RUNS 10
+
+/**
+  @brief        Benchmark of the arc accesses of the IO acknowledges
+  @param[in]    none
+  @return       none
+
+  @par          An RX IO and a TX IO exchange frames through the same arc, the TX acknowledge
+                realigns the arc. The processor time is printed in nanoseconds per acknowledge,
+                it covers the descriptor, base address, index and flow error table accesses.
+                Only the time is measured : the L1 misses of the layouts (ARC_HOT_COLD_SPLIT,
+                CACHE_LINE_BYTE_LENGTH) are read with "perf stat -e L1-dcache-load-misses" on
+                a host with hardware counters, this comparison is not made by the harness.
+ */
+void graph_test_benchmark_arc_access(void)
+{
+    static uint8_t frame[BENCHMARK_ARC_FRAME];
+    uint32_t loop, run;
+    clock_t start;
+    double seconds, t;
+
+    graph_test_enter();
+    graph_test_arc(0, TEST_ARC_BYTES, BENCHMARK_ARC_FRAME, 0);
+    graph_test_io(0, 0, 0, 0);
+    graph_test_io(1, 0, 1, 0);
+
+    /* best of BENCHMARK_ARC_RUNS runs, to remove the preemptions of the host */
+    seconds = 0;
+    for (run = 0; run < BENCHMARK_ARC_RUNS; run++)
+    {   start = clock();
+        for (loop = 0; loop < BENCHMARK_ARC_LOOPS; loop++)
+        {   NanoGraph_io_ack(0, frame, BENCHMARK_ARC_FRAME);
+            NanoGraph_io_ack(1, frame, BENCHMARK_ARC_FRAME);
+        }
+        t = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+        if (run == 0 || t < seconds)
+        {   seconds = t;
+        }
+    }
+
+    printf("arc access : %.2f ns per IO acknowledge, %d overflows %d underflows\n",
+        1e9 * seconds / (2.0 * BENCHMARK_ARC_LOOPS), (int)test_flow_errors[OVERFLOW_FLOWCNT], (int)test_flow_errors[UNDERFLOW_FLOWCNT]);
+    graph_test_leave();
+}
+#endif
+
+#if defined(BENCHMARK_IO_ACK_POST) && defined(IO_ACK_QUEUE)
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+
+#define BENCHMARK_POST_FRAME (TEST_ARC_BYTES / IO_ACK_QUEUE)
+#define BENCHMARK_POST_BATCH (IO_ACK_QUEUE / 2)     /* the arc holds a batch, then it is emptied */
+#define BENCHMARK_POST_LOOPS 100000     /* batches */
+
+static uint8_t benchmark_post_frame[BENCHMARK_POST_FRAME];
+static double benchmark_post_ns;
+
+static double benchmark_post_now (void)
+{   struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return 1e9 * (double)t.tv_sec + (double)t.tv_nsec;
+}
+
+/**
+  @brief        producer thread of the benchmark, the "IO interrupt"
+  @param[in]    arg     instance of the test graph
+  @return       none
+
+  @par          Posts batches of BENCHMARK_POST_BATCH acknowledges when the queue is empty, 
+                only the time spent in NanoGraph_io_ack_post() is measured (best batch, to 
+                remove the preemptions of the host).
+ */
+static void *benchmark_post_producer (void *arg)
+{
+    nanograph_instance_t *S = (nanograph_instance_t *)arg;
+    uint32_t loop, i;
+    double t;
+
+    benchmark_post_ns = 0;
+    for (loop = 0; loop < BENCHMARK_POST_LOOPS; loop++)
+    {   while (S->io_ack_posted != ARC_LOAD_ACQUIRE(S->io_ack_drained))
+        {   sched_yield();
+        }
+        t = benchmark_post_now();
+        for (i = 0; i < BENCHMARK_POST_BATCH; i++)
+        {   NanoGraph_io_ack_post(0, benchmark_post_frame, BENCHMARK_POST_FRAME);
+        }
+        t = (benchmark_post_now() - t) / BENCHMARK_POST_BATCH;
+        if (loop == 0 || t < benchmark_post_ns)
+        {   benchmark_post_ns = t;
+        }
+    }
+    return 0;
+}
+
+/**
+  @brief        Benchmark of the producer side of the IO acknowledges
+  @param[in]    none
+  @return       none
+
+  @par          Time spent by the IO interrupt to give a frame of BENCHMARK_POST_FRAME bytes 
+                to the graph : with NanoGraph_io_ack() the frame is copied in the arc by the 
+                caller, with NanoGraph_io_ack_post() a thread only posts it and this thread 
+                (the scheduler) drains the queue. The arc is emptied after each batch. The 
+                dropped posts (io_ack_overflow) and the overflows of the arc are printed.
+ */
+void graph_test_benchmark_io_ack_post(void)
+{
+    nanograph_instance_t *S;
+    pthread_t producer;
+    uint32_t loop, i;
+    double t, ack_ns;
+
+    S = graph_test_enter();
+    graph_test_arc(0, TEST_ARC_BYTES, BENCHMARK_POST_FRAME, 0);
+    graph_test_io(0, 0, 0, 0);
+
+    /* immediate acknowledges : the copy is made by the caller */
+    ack_ns = 0;
+    for (loop = 0; loop < BENCHMARK_POST_LOOPS; loop++)
+    {   t = benchmark_post_now();
+        for (i = 0; i < BENCHMARK_POST_BATCH; i++)
+        {   NanoGraph_io_ack(0, benchmark_post_frame, BENCHMARK_POST_FRAME);
+        }
+        t = (benchmark_post_now() - t) / BENCHMARK_POST_BATCH;
+        if (loop == 0 || t < ack_ns)
+        {   ack_ns = t;
+        }
+        graph_test_arc(0, TEST_ARC_BYTES, BENCHMARK_POST_FRAME, 0);
+    }
+
+    /* posted acknowledges : the copy is made by the scheduler */
+    S->io_ack_posted = S->io_ack_drained = S->io_ack_overflow = 0;
+    pthread_create(&producer, 0, benchmark_post_producer, S);
+    for (loop = 0; loop < BENCHMARK_POST_LOOPS * BENCHMARK_POST_BATCH; )
+    {   if (S->io_ack_drained == ARC_LOAD_ACQUIRE(S->io_ack_posted))
+        {   sched_yield();
+            continue;
+        }
+        loop += ARC_LOAD_ACQUIRE(S->io_ack_posted) - S->io_ack_drained;
+        io_ack_drain(S);
+        graph_test_arc(0, TEST_ARC_BYTES, BENCHMARK_POST_FRAME, 0);
+    }
+    pthread_join(producer, 0);
+
+    printf("IO acknowledge of %d bytes : %.2f ns in the interrupt with io_ack, %.2f ns with io_ack_post, %d dropped posts %d overflows\n",
+        BENCHMARK_POST_FRAME, ack_ns, benchmark_post_ns, (int)S->io_ack_overflow, (int)test_flow_errors[OVERFLOW_FLOWCNT]);
+    graph_test_leave();
+}
+#endif
+
+#if defined(TEST_DRIFT_HOUR) && defined(IO_DRIFT_COMPENSATION)
+#include <stdio.h>
+
+extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+
+#define TEST_DRIFT_FRAME    48          /* samples per acknowledge, 1ms at 48kHz */
+#define TEST_DRIFT_PPM      100         /* the clock of the IO is faster than the clock of the graph */
+#define TEST_DRIFT_SECONDS  3600
+#define TEST_DRIFT_WARMUP   60          /* seconds of convergence of the controller */
+
+/**
+  @brief        One hour of a resampled RX stream on a clock drifting by TEST_DRIFT_PPM
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          A mono 16-bit IO acknowledges frames of TEST_DRIFT_FRAME samples with 
+                DRIFTCOMP_IOFMT1, a TX IO consumes half frames at the nominal rate once the 
+                arc is half full : the realignment requested by the producer (ALIGNBLCK) is 
+                made before the next RX frame, a second RX frame blocked by ALIGNBLCK would be 
+                lost. The frames are longer than 16 samples : the phase of the resampler covers 
+                more than the Q28 range. After the warm-up no overflow nor underflow is accepted, 
+                the average resampling step matches the drift and the arc stays around half full.
+ */
+uint32_t graph_test_drift_hour(void)
+{
+    nanograph_instance_t *S;
+    static int16_t frame[TEST_DRIFT_FRAME];
+    uint32_t fmt1, iofmt1, i, counter, started, fail = 0, errors_warmup = 0, occupancy, step_count = 0;
+    double t_rx, t_tx, step_sum = 0;
+    int32_t ppm;
+
+    S = graph_test_enter();
+    fmt1 = 0;
+    ST(fmt1, RAW_FMT1, NANOGRAPH_S16);
+    graph_test_arc(0, TEST_ARC_BYTES, 2 * TEST_DRIFT_FRAME, fmt1);
+    iofmt1 = 0;
+    SET_BIT(iofmt1, DRIFTCOMP_IOFMT1_LSB);
+    graph_test_io(0, 0, 0, iofmt1);
+    graph_test_io(1, 0, 1, 0);
+
+    counter = started = 0;
+    t_rx = 0;
+    t_tx = 0.0005;
+    while (t_rx < TEST_DRIFT_SECONDS)
+    {   if (t_rx <= t_tx)
+        {   for (i = 0; i < TEST_DRIFT_FRAME; i++)
+            {   frame[i] = (int16_t)(counter++ * 7);
+            }
+            NanoGraph_io_ack(0, frame, sizeof(frame));
+            t_rx += 0.001 / (1.0 + TEST_DRIFT_PPM * 1e-6);
+            if (ARC_WRITE(S, 0) - ARC_READ(S, 0) >= TEST_ARC_BYTES / 2)
+            {   started = 1;
+            }
+            if (errors_warmup != 0)
+            {   step_sum += (double)(int32_t)(test_arc_drift[STEP_DRIFT] - DRIFT_UNITY);
+                step_count++;
+            }
+        }
+        else
+        {   if (started)
+            {   NanoGraph_io_ack(1, frame, sizeof(frame) / 2);
+            }
+            t_tx += 0.0005;
+        }
+        if (errors_warmup == 0 && t_rx >= TEST_DRIFT_WARMUP)
+        {   errors_warmup = 1 + test_flow_errors[OVERFLOW_FLOWCNT] + test_flow_errors[UNDERFLOW_FLOWCNT];
+        }
+    }
+
+    /* the step follows the occupancy sawtooth of the frames, its average is the drift */
+    ppm = (int32_t)((step_sum * 1e6) / ((double)step_count * DRIFT_UNITY));
+    occupancy = ARC_WRITE(S, 0) - ARC_READ(S, 0);
+    if (1 + test_flow_errors[OVERFLOW_FLOWCNT] + test_flow_errors[UNDERFLOW_FLOWCNT] != errors_warmup)
+    {   fail++;
+    }
+    if (ppm < TEST_DRIFT_PPM * 8 / 10 || ppm > TEST_DRIFT_PPM * 12 / 10)
+    {   fail++;
+    }
+    if (occupancy < TEST_ARC_BYTES / 4 || occupancy > 3 * TEST_ARC_BYTES / 4)
+    {   fail++;
+    }
+
+    printf("drift one hour : average step %+d ppm, occupancy %d, %d overflows %d underflows, %d failed checks\n",
+        (int)ppm, (int)occupancy, (int)test_flow_errors[OVERFLOW_FLOWCNT], (int)test_flow_errors[UNDERFLOW_FLOWCNT], (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
+#if defined(TEST_IO_COALESCING) && defined(IO_COALESCING)
+#include <stdio.h>
+
+extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+
+#define TEST_COALESCE_ARC       100     /* bytes of the arc */
+#define TEST_COALESCE_PRODUCER  8       /* ALIGNBLCK when the write index passes 92 */
+#define TEST_COALESCE_CONSUMER  96      /* the small acknowledges are staged up to 96 bytes */
+
+/**
+  @brief        RX acknowledge of the coalescing IO, the bytes are a counter
+  @param[in]    counter     next byte of the stream, incremented
+  @param[in]    nbytes      size of the acknowledge
+  @return       none
+ */
+static void test_coalesce_ack (uint8_t *counter, uint32_t nbytes)
+{
+    static uint8_t frame[TEST_COALESCE_ARC];
+    uint32_t i;
+
+    for (i = 0; i < nbytes; i++)
+    {   frame[i] = (*counter)++;
+    }
+    NanoGraph_io_ack(0, frame, nbytes);
+}
+
+/**
+  @brief        consumer of the coalescing test : checks the published data and realigns the arc
+  @param[in]    S           instance
+  @param[in]    first       expected first byte
+  @param[in]    nbytes      expected published bytes
+  @return       number of failed checks
+ */
+static uint32_t test_coalesce_consume (nanograph_instance_t *S, uint8_t first, uint32_t nbytes)
+{
+    uint32_t i, wr_w32, fail = 0;
+
+    wr_w32 = ARC_WR_LOAD(S, 0);
+    if (ARC_WRITE(S, 0) != nbytes || 0 == TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB) || 
+        0 != S->arc_staging[STAGED_ARCSTG])
+    {   fail++;
+    }
+    for (i = 0; i < nbytes; i++)
+    {   if (ARC_BASE(S, 0)[i] != (uint8_t)(first + i))
+        {   fail++;
+            break;
+        }
+    }
+    ARC_ST_READ(S, 0, 0);
+    ARC_ST_WRITE(S, 0, wr_w32, 0)
+    CLEAR_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
+    ARC_WR_STORE(S, 0, wr_w32);
+    return fail;
+}
+
+/**
+  @brief        Test of the end of the buffer reached with RX data staged (IO_COALESCING)
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          The acknowledges are staged after the write index until the consumer frame is 
+                complete. The end of the buffer is reached with staged data in two ways : the 
+                write index passes the realignment limit (ALIGNBLCK is set by the acknowledge), 
+                or the next acknowledge does not fit (overflow). In both cases the staged data 
+                is published once, the staged count is cleared and the consumer realigns : the 
+                next acknowledges and the timeout of the scheduler must not publish it again.
+ */
+uint32_t graph_test_io_coalescing(void)
+{
+    extern uint64_t global_nanograph_time64;
+    nanograph_instance_t *S;
+    uint32_t iofmt1, i, fail = 0;
+    uint8_t counter;
+
+    S = graph_test_enter();
+    graph_test_arc(0, TEST_COALESCE_ARC, TEST_COALESCE_PRODUCER, 0);
+    graph_test_arc(1, TEST_COALESCE_ARC, TEST_COALESCE_CONSUMER, 0);
+    ST(ARC_DESC(S, 0)[FMT_ARCW4], CONSUMFMT_ARCW4, 1);
+    iofmt1 = 0;
+    ST(iofmt1, COALESCE_IOFMT1, 10);
+    graph_test_io(0, 0, 0, iofmt1);
+    global_nanograph_time64 = 0;
+    counter = 0;
+
+    /* ALIGNBLCK : 5 acknowledges of 16 bytes are staged, the 6th one passes the limit */
+    for (i = 0; i < 5; i++)
+    {   test_coalesce_ack(&counter, 16);
+        if (ARC_WRITE(S, 0) != 0 || S->arc_staging[STAGED_ARCSTG] != 16 * (i + 1))
+        {   fail++;
+        }
+    }
+    test_coalesce_ack(&counter, 16);
+    test_coalesce_ack(&counter, 16);                /* lost : the consumer realigns */
+    fail += test_coalesce_consume(S, 0, 96);
+    if (S->arc_flow_errors[OVERFLOW_FLOWCNT] != 1)
+    {   fail++;
+    }
+    test_coalesce_ack(&counter, 16);                /* staged again from the base address */
+    if (ARC_WRITE(S, 0) != 0 || S->arc_staging[STAGED_ARCSTG] != 16 || ARC_BASE(S, 0)[0] != 112)
+    {   fail++;
+    }
+
+    /* overflow : 30, 60, 90 bytes are staged, the 4th acknowledge of 30 bytes does not fit */
+    graph_test_arc(0, TEST_COALESCE_ARC, TEST_COALESCE_PRODUCER, 0);
+    ST(ARC_DESC(S, 0)[FMT_ARCW4], CONSUMFMT_ARCW4, 1);
+    counter = 0;
+    for (i = 0; i < 4; i++)
+    {   test_coalesce_ack(&counter, 30);
+    }
+    if (S->arc_flow_errors[OVERFLOW_FLOWCNT] != 1)
+    {   fail++;
+    }
+    global_nanograph_time64 = (uint64_t)1 << 28;    /* the timeout has nothing left to publish */
+    io_coalesce_timeout(S, 0, 0);
+    fail += test_coalesce_consume(S, 0, 90);
+
+    printf("IO coalescing : %d failed checks\n", (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
+#if defined(TEST_IO_CONVERSION) && defined(IO_FORMAT_CONVERSION)
+#include <stdio.h>
+
+extern void NanoGraph_io_ackv (uint8_t graph_hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments);
+
+/**
+  @brief        Test of the sample conversions of the IO acknowledges (IORAW_IOFMT1)
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          24-bit IO samples split between two segments (a DMA ring wrapping in the 
+                middle of a sample) are carried to the next segment on RX and TX, FP32 IO 
+                samples saturate and NaN gives silence, big-endian 16-bit samples are swapped.
+ */
+uint32_t graph_test_io_conversion(void)
+{
+    nanograph_instance_t *S;
+    nanograph_io_segment_t seg[2];
+    uint32_t fmt1, iofmt1, i, fail = 0;
+    uint8_t s23[12], tx23[12];
+    int32_t *s32;
+    int16_t *s16;
+    conv_int32_fp32_t f32[4];
+    uint16_t be16[2];
+
+    S = graph_test_enter();
+
+    /* RX S23 -> S32, 4 samples in segments of 4 and 8 bytes */
+    fmt1 = 0;
+    ST(fmt1, RAW_FMT1, NANOGRAPH_S32);
+    graph_test_arc(0, 64, 16, fmt1);
+    iofmt1 = 0;
+    ST(iofmt1, IORAW_IOFMT1, NANOGRAPH_S23);
+    graph_test_io(0, 0, 0, iofmt1);
+    for (i = 0; i < 4; i++)                         /* 0x123456 + i, little-endian */
+    {   s23[3 * i + 0] = (uint8_t)(0x56 + i);
+        s23[3 * i + 1] = 0x34;
+        s23[3 * i + 2] = (uint8_t)((i & 1) ? 0x92 : 0x12);     /* odd samples negative */
+    }
+    seg[0].data = s23;      seg[0].size = 4;
+    seg[1].data = &s23[4];  seg[1].size = 8;
+    NanoGraph_io_ackv(0, seg, 2);
+    s32 = (int32_t *)ARC_BASE(S, 0);
+    if (ARC_WRITE(S, 0) != 16)
+    {   fail++;
+    }
+    for (i = 0; i < 4; i++)
+    {   if ((uint32_t)s32[i] != ((((i & 1) ? 0x923400u : 0x123400u) + 0x56 + i) << 8))
+        {   fail++;
+        }
+    }
+
+    /* TX S32 -> S23 of the same samples, segments of 5 and 7 bytes */
+    graph_test_io(1, 0, 1, iofmt1);
+    MEMSET(tx23, 0, sizeof(tx23))
+    seg[0].data = tx23;     seg[0].size = 5;
+    seg[1].data = &tx23[5]; seg[1].size = 7;
+    NanoGraph_io_ackv(1, seg, 2);
+    if (ARC_READ(S, 0) != 16)
+    {   fail++;
+    }
+    for (i = 0; i < sizeof(s23); i++)
+    {   if (tx23[i] != s23[i])
+        {   fail++;
+            break;
+        }
+    }
+
+    /* RX FP32 -> S16 : saturation and NaN */
+    fmt1 = 0;
+    ST(fmt1, RAW_FMT1, NANOGRAPH_S16);
+    graph_test_arc(0, 64, 8, fmt1);
+    iofmt1 = 0;
+    ST(iofmt1, IORAW_IOFMT1, NANOGRAPH_FP32);
+    graph_test_io(0, 0, 0, iofmt1);
+    f32[0].f = 0.5f;
+    f32[1].f = 2.0f;
+    f32[2].f = -2.0f;
+    f32[3].u = 0x7FC00000u;                         /* quiet NaN */
+    seg[0].data = f32;      seg[0].size = sizeof(f32);
+    NanoGraph_io_ackv(0, seg, 1);
+    s16 = (int16_t *)ARC_BASE(S, 0);
+    if (ARC_WRITE(S, 0) != 8 || s16[0] != 0x4000 || s16[1] != 0x7FFF || s16[2] != -0x8000 || s16[3] != 0)
+    {   fail++;
+    }
+
+    /* RX big-endian S16 -> S16 */
+    graph_test_arc(0, 64, 4, fmt1);
+    iofmt1 = 0;
+    ST(iofmt1, IORAW_IOFMT1, NANOGRAPH_S16);
+    SET_BIT(iofmt1, IOBSWAP_IOFMT1_LSB);
+    graph_test_io(0, 0, 0, iofmt1);
+    be16[0] = 0x3412;
+    be16[1] = 0xCDAB;
+    seg[0].data = be16;     seg[0].size = sizeof(be16);
+    NanoGraph_io_ackv(0, seg, 1);
+    if (ARC_WRITE(S, 0) != 4 || (uint16_t)s16[0] != 0x1234 || (uint16_t)s16[1] != 0xABCD)
+    {   fail++;
+    }
+
+    printf("IO conversion : %d failed checks\n", (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
+#if defined(TEST_ARC_PLANAR) && defined(ARC_PLANAR)
+#include <stdio.h>
+
+extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+extern void NanoGraph_io_ackv (uint8_t graph_hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments);
+
+#define TEST_PLANAR_NCHAN   3
+#define TEST_PLANAR_SAMPLES 16      /* per channel and per frame */
+#define TEST_PLANAR_PLANE   128     /* multiple of PLANE_ALIGNMENT_BYTES */
+
+/**
+  @brief        Round trip of a 3-channel stream through a planar arc
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          The consumer format of the arc is FMT_DEINTERLEAVED_PLANAR : the RX IO 
+                deinterleaves its 16-bit frames to the planes, the TX IO interleaves them back 
+                and realigns each plane when the producer asks for it (ALIGNBLCK). The planes 
+                are checked after each RX frame, the TX frames must equal the RX frames.
+                A frame given in two segments of whole samples is deinterleaved like one buffer, 
+                a segment ending in the middle of a sample rejects the frame (overflow).
+ */
+uint32_t graph_test_arc_planar(void)
+{
+    nanograph_instance_t *S;
+    nanograph_io_segment_t seg[2];
+    int16_t frame[TEST_PLANAR_NCHAN * TEST_PLANAR_SAMPLES], *plane;
+    uint32_t fmt1, op, nrx, ntx, i, ichan, fail = 0;
+    static const char sequence[] = "RRTRRTTT";     /* the fourth RX frame asks for a realignment */
+
+    S = graph_test_enter();
+    fmt1 = 0;
+    ST(fmt1, RAW_FMT1, NANOGRAPH_S16);
+    ST(fmt1, NCHANM1_FMT1, TEST_PLANAR_NCHAN - 1);
+    ST(fmt1, INTERLEAV_FMT1, FMT_DEINTERLEAVED_PLANAR);
+    graph_test_arc(0, TEST_PLANAR_NCHAN * TEST_PLANAR_PLANE, sizeof(frame), fmt1);
+    SET_BIT(ARC_DESC(S, 0)[FMT_ARCW4], PLANAR_ARCW4_LSB);      /* set at reset from the consumer format */
+    graph_test_io(0, 0, 0, 0);
+    graph_test_io(1, 0, 1, 0);
+
+    for (nrx = ntx = op = 0; op < sizeof(sequence) - 1; op++)
+    {   if (sequence[op] == 'R')
+        {   for (i = 0; i < TEST_PLANAR_SAMPLES; i++)
+            {   for (ichan = 0; ichan < TEST_PLANAR_NCHAN; ichan++)
+                {   frame[TEST_PLANAR_NCHAN * i + ichan] = (int16_t)(1000 * ichan + 100 * nrx + i);
+                }
+            }
+            NanoGraph_io_ack(0, frame, sizeof(frame));
+
+            /* the new samples of each channel are contiguous in its plane */
+            for (ichan = 0; ichan < TEST_PLANAR_NCHAN; ichan++)
+            {   plane = (int16_t *)(ARC_BASE(S, 0) + ichan * TEST_PLANAR_PLANE + (ARC_WRITE(S, 0) - sizeof(frame)) / TEST_PLANAR_NCHAN);
+                for (i = 0; i < TEST_PLANAR_SAMPLES; i++)
+                {   if (plane[i] != (int16_t)(1000 * ichan + 100 * nrx + i))
+                    {   fail++;
+                        break;
+                    }
+                }
+            }
+            nrx++;
+        }
+        else
+        {   MEMSET(frame, 0, sizeof(frame))
+            NanoGraph_io_ack(1, frame, sizeof(frame));
+            for (i = 0; i < TEST_PLANAR_SAMPLES; i++)
+            {   for (ichan = 0; ichan < TEST_PLANAR_NCHAN; ichan++)
+                {   if (frame[TEST_PLANAR_NCHAN * i + ichan] != (int16_t)(1000 * ichan + 100 * ntx + i))
+                    {   fail++;
+                        i = TEST_PLANAR_SAMPLES;
+                        break;
+                    }
+                }
+            }
+            ntx++;
+        }
+    }
+    if (ARC_READ(S, 0) != ARC_WRITE(S, 0) || ARC_WRITE(S, 0) != 2 * sizeof(frame) ||
+        test_flow_errors[OVERFLOW_FLOWCNT] + test_flow_errors[UNDERFLOW_FLOWCNT] != 0)
+    {   fail++;
+    }
+
+    /* segments of 8 samples of the 3 channels, then a segment split in a sample */
+    for (i = 0; i < TEST_PLANAR_NCHAN * TEST_PLANAR_SAMPLES; i++)
+    {   frame[i] = (int16_t)i;
+    }
+    seg[0].data = frame;
+    seg[0].size = sizeof(frame) / 2;
+    seg[1].data = (uint8_t *)frame + sizeof(frame) / 2;
+    seg[1].size = sizeof(frame) / 2;
+    NanoGraph_io_ackv(0, seg, 2);
+    for (ichan = 0; ichan < TEST_PLANAR_NCHAN; ichan++)
+    {   plane = (int16_t *)(ARC_BASE(S, 0) + ichan * TEST_PLANAR_PLANE + 2 * sizeof(frame) / TEST_PLANAR_NCHAN);
+        for (i = 0; i < TEST_PLANAR_SAMPLES; i++)
+        {   if (plane[i] != (int16_t)(TEST_PLANAR_NCHAN * i + ichan))
+            {   fail++;
+                break;
+            }
+        }
+    }
+    seg[0].size = sizeof(frame) / 2 - 2;
+    seg[1].data = (uint8_t *)frame + seg[0].size;
+    seg[1].size = sizeof(frame) / 2 + 2;
+    NanoGraph_io_ackv(0, seg, 2);
+    if (ARC_WRITE(S, 0) != 3 * sizeof(frame) || test_flow_errors[OVERFLOW_FLOWCNT] != 1)
+    {   fail++;
+    }
+
+    printf("planar arc round trip : %d channels, %d failed checks\n", TEST_PLANAR_NCHAN, (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
+#ifdef TEST_ARC_HISTORY
+#include <stdio.h>
+
+#define TEST_HISTORY_FRAME  64
+#define TEST_HISTORY_SAMP   8
+
+/**
+  @brief        Test of the initialization of the arc history (HISTORY_FMT0)
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          A mono 16-bit arc with TEST_HISTORY_SAMP samples of history starts with 
+                null data before the read index. A history leaving no room for the producer 
+                frame, and a consumer format out of the table of formats, reject the graph.
+ */
+uint32_t graph_test_arc_history(void)
+{
+    nanograph_instance_t *S;
+    uint32_t fmt1, history, fail = 0;
+
+    S = graph_test_enter();
+    ST(S->scheduler_control, MAININST_SCTRL, GLOBAL_MAIN_INSTANCE);
+    fmt1 = 0;
+    ST(fmt1, RAW_FMT1, NANOGRAPH_S16);
+    history = TEST_HISTORY_SAMP * 2;
+
+    /* accepted : RD = WR = history, null history */
+    graph_test_arc(0, 256, TEST_HISTORY_FRAME, fmt1);
+    ST(test_formats[FRAMESZ_FMT0], HISTORY_FMT0, TEST_HISTORY_SAMP);
+    MEMSET(test_buffers[0], 0xFF, TEST_ARC_BYTES)
+    if (0 != arc_history_init(S, 1, 1) || ARC_READ(S, 0) != history || ARC_WRITE(S, 0) != history)
+    {   fail++;
+    }
+    if (((uint8_t *)test_buffers[0])[0] != 0 || ((uint8_t *)test_buffers[0])[history - 1] != 0 || ((uint8_t *)test_buffers[0])[history] != 0xFF)
+    {   fail++;
+    }
+
+    /* rejected : history + producer frame larger than the buffer */
+    graph_test_arc(0, history + TEST_HISTORY_FRAME - 1, TEST_HISTORY_FRAME, fmt1);
+    ST(test_formats[FRAMESZ_FMT0], HISTORY_FMT0, TEST_HISTORY_SAMP);
+    if (ERROR_LOG_HISTORY != arc_history_init(S, 1, 1))
+    {   fail++;
+    }
+
+    /* rejected : consumer format out of the table */
+    graph_test_arc(0, 256, TEST_HISTORY_FRAME, fmt1);
+    graph_test_arc(1, 256, TEST_HISTORY_FRAME, fmt1);
+    if (ERROR_LOG_HISTORY != arc_history_init(S, 2, 1))
+    {   fail++;
+    }
+
+    printf("arc history : %d failed checks\n", (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -39,8 +39,13 @@
 
 #include "../nanograph_common.h"
 #include "../nanograph_interpreter.h"
+#include "graph_test.h"
 
 extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+extern void io_audio_in_0_dma (const uint8_t *src, uint32_t nbytes);
+extern void io_2d_in_0_line (const uint8_t *src, uint32_t nbytes);
+extern uint32_t io_shm_poll (void);
+extern uint32_t io_replay_feed (uint64_t time64);
 extern void graph_test_scheduler(uint64_t time64);
 
 #define BareMetalTaskHandle0_mask (1 << 0)
@@ -62,6 +67,9 @@ const int16_t  tstaudio_in_1 [] =
     #include "io_test_audio_in_0.txt"
 };
 
+#define AUDIOINFRAMESIZE 32     /* 1ms mono 16b 16kHz, three frames per half of the audio_in_0 DMA */
+#define IMAGE2DLINESIZE 24      /* camera line of 2d_in_0, four lines per band, the pixels are the samples of tstaudio_in_1 */
+
 #define UIOUT0SIZE 16
 uint32_t tst_ui_out_0[UIOUT0SIZE];
 
@@ -128,13 +136,13 @@ const io_test_struct_t ios[MAX_NBGRAPHIO] =
   { IO_PLATFORM_SERIAL_OUT_0 ,        0,              0,              0,              0,          0 }, // SERIAL_OUT_0      20
   { IO_PLATFORM_ANALOG_IN_0  ,        0,              0,              0,              0,          0 }, // ANALOG_IN_0       21
   { IO_PLATFORM_ANALOG_OUT_0 ,        0,              0,              0,              0,          0 }, // ANALOG_OUT_0      22
-  { IO_PLATFORM_AUDIO_IN_0   ,        0,              0,              0,              0,          0 }, // AUDIO_IN_0        23
+  { IO_PLATFORM_AUDIO_IN_0   , (uint8_t*)tstaudio_in_0, sizeof(tstaudio_in_0), AUDIOINFRAMESIZE, GTIMESEC(0.001), 0 }, // AUDIO_IN_0        23
   { IO_PLATFORM_AUDIO_IN_1   ,        0,              0,              0,              0,          0 }, // AUDIO_IN_1        24
   { IO_PLATFORM_AUDIO_IN_2   ,        0,              0,              0,              0,          0 }, // AUDIO_IN_2        25
   { IO_PLATFORM_AUDIO_OUT_0  ,        0,              0,              0,              0,          0 }, // AUDIO_OUT_0       26
   { IO_PLATFORM_AUDIO_OUT_1  ,        0,              0,              0,              0,          0 }, // AUDIO_OUT_1       27
   { IO_PLATFORM_AUDIO_OUT_2  ,        0,              0,              0,              0,          0 }, // AUDIO_OUT_2       28
-  { IO_PLATFORM_2D_IN_0      ,        0,              0,              0,              0,          0 }, // 2D_IN_0           30
+  { IO_PLATFORM_2D_IN_0      , (uint8_t*)tstaudio_in_1, sizeof(tstaudio_in_1), IMAGE2DLINESIZE, GTIMESEC(0.001), 0 }, // 2D_IN_0           30
   { IO_PLATFORM_2D_IN_1      ,        0,              0,              0,              0,          0 }, // 2D_IN_1           31
   { IO_PLATFORM_2D_OUT_0     ,        0,              0,              0,              0,          0 }, // 2D_OUT_0          32
   { IO_PLATFORM_2D_OUT_1     ,        0,              0,              0,              0,          0 }, // 2D_OUT_1          33
@@ -142,12 +150,15 @@ const io_test_struct_t ios[MAX_NBGRAPHIO] =
 
     
 
+static uint64_t io_counter[MAX_NBGRAPHIO];        /* time of the next frame of each IO */
+
 void graph_test_scheduler(uint64_t time64)
 {
-    static uint64_t io_counter[MAX_NBGRAPHIO];
+#ifndef IO_REPLAY
     static uint32_t read_index[MAX_NBGRAPHIO];
-    static uint8_t initialization;
     uint8_t *pt8;
+#endif
+    static uint8_t initialization;
     uint32_t i, threads;
     
 
@@ -162,6 +173,12 @@ void graph_test_scheduler(uint64_t time64)
 
     /* call the graph scheduler if this time to exchange new data */
     threads = 0;
+#ifdef IO_REPLAY
+    /* the recorded IO events replace the test patterns and the IO drivers */
+    if (io_replay_feed(time64))
+    {   threads |= 1;
+    }
+#else
     for (i = 1; i < MAX_NBGRAPHIO; i++)
     {   
         if (ios[i].frame_length == 0)
@@ -170,7 +187,15 @@ void graph_test_scheduler(uint64_t time64)
         if (time64 > io_counter[i])
         {   
             pt8 = ios[i].data + read_index[i];
-            NanoGraph_io_ack(ios[i].IOIDX, pt8, ios[i].frame_length);
+            if (ios[i].IOIDX == IO_PLATFORM_AUDIO_IN_0)
+            {   io_audio_in_0_dma(pt8, ios[i].frame_length);    /* ping-pong DMA, zero-copy in the graph */
+            }
+            else if (ios[i].IOIDX == IO_PLATFORM_2D_IN_0)
+            {   io_2d_in_0_line(pt8, ios[i].frame_length);      /* one line, acknowledged by bands */
+            }
+            else
+            {   NanoGraph_io_ack(ios[i].IOIDX, pt8, ios[i].frame_length);
+            }
             read_index[i] += ios[i].frame_length;
             if (read_index[i] >= (ios[i].buffer_size - ios[i].frame_length))
             {
@@ -184,6 +209,14 @@ void graph_test_scheduler(uint64_t time64)
             threads |= 1 << (ios[i].instance_affinity);
         }
     }
+#endif
+
+#ifdef PLATFORM_SHM_IO
+    /* frames exchanged with the other process since the last tick */
+    if (io_shm_poll())
+    {   threads |= 1;
+    }
+#endif
 
     /* awake the thread of instance 0 */
     if (threads & 1)
@@ -218,6 +251,701 @@ void graph_test_scheduler(uint64_t time64)
 }
 
 
+#ifdef VIRTUAL_TIME
+#include <stdio.h>
+#include <time.h>
+
+/* wall time in q32.28 [s], the speed-up is seen by the user, not the processor time of clock() */
+static uint64_t virtual_time_wall64(void)
+{   struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec << 28) + (((uint64_t)t.tv_nsec << 28) / 1000000000u);
+}
+
+/**
+  @brief        simulation in virtual time, as fast as the processor allows
+  @param[in]    none
+  @return       speed-up : seconds of simulated IO streams per second of wall time
+
+  @par          Replaces the systick : when the graph is idle the time jumps to the next frame of 
+                the IOs of "ios[]", graph_test_scheduler() acknowledges it and runs the graph. The 
+                processor time of this run is subtracted from the period of the IOs acknowledged 
+                before it, the smallest difference is the deadline slack of the IO (negative : the 
+                real-time platform misses the deadline). The simulation ends with one_file_is_closed.
+                Called once by main_run(), the following calls of main_run() come from the scheduler.
+                With IO_REPLAY the events are replayed with IO_REPLAY_FAST.
+ */
+float graph_test_virtual_time(void)
+{
+    extern uint8_t one_file_is_closed;
+    uint64_t previous[MAX_NBGRAPHIO];
+    int64_t slack[MAX_NBGRAPHIO], s;
+    uint64_t now, next, start64, wall64, start, w0;
+    uint32_t i;
+
+    now = global_nanograph_time64;
+    graph_test_scheduler(now);                      /* initialization of io_counter[] */
+    start64 = now;
+    start = virtual_time_wall64();
+    for (i = 0; i < MAX_NBGRAPHIO; i++)
+    {   slack[i] = INT64_MAX;
+    }
+
+    while (0 == one_file_is_closed)
+    {
+        /* the graph is idle : jump to the next frame */
+        next = UINT64_MAX;
+        for (i = 1; i < MAX_NBGRAPHIO; i++)
+        {   if (ios[i].frame_length != 0)
+            {   next = MIN(next, io_counter[i]);
+            }
+        }
+        if (next == UINT64_MAX)
+        {   break;                                  /* no IO in the test patterns */
+        }
+        now = next + 1;                             /* acknowledged when time64 > io_counter */
+        global_nanograph_time64 = now;
+        MEMCPY(previous, io_counter, MAX_NBGRAPHIO)     /* elements, not bytes */
+
+        w0 = virtual_time_wall64();
+        graph_test_scheduler(now);
+        wall64 = virtual_time_wall64() - w0;
+
+        /* slack of the IOs acknowledged at this step */
+        for (i = 1; i < MAX_NBGRAPHIO; i++)
+        {   if (io_counter[i] != previous[i])
+            {   s = (int64_t)ios[i].period - (int64_t)wall64;
+                slack[i] = MIN(slack[i], s);
+            }
+        }
+    }
+
+    wall64 = virtual_time_wall64() - start;
+    wall64 = MAX(wall64, 1);
+
+    printf("virtual time : %.3f s simulated in %.3f s, speed-up %.1f\n", 
+        (double)(now - start64) / (double)(1L << 28), (double)wall64 / (double)(1L << 28),
+        (double)(now - start64) / (double)wall64);
+    for (i = 1; i < MAX_NBGRAPHIO; i++)
+    {   if (slack[i] != INT64_MAX)
+        {   printf("IO %2d : deadline slack %.1f us\n", ios[i].IOIDX, 1e6 * (double)slack[i] / (double)(1L << 28));
+        }
+    }
+
+    return (float)(now - start64) / (float)wall64;
+}
+#endif
+
+#ifdef BENCHMARK_DF1_Q15
+#include <stdio.h>
+#include <time.h>
+
+#define BENCHMARK_DF1_FRAME 1024
+#define BENCHMARK_DF1_LOOPS 1000
+#define BENCHMARK_DF1_STAGES 8
+
+/**
+  @brief        Benchmark of the Q15 DF1 biquad service (SERV_DSP_CASCADE_DF1_Q15)
+  @param[in]    none
+  @return       none
+
+  @par          The service is called through nanograph_services() like the filter nodes, with 
+                1, 2, 4 and 8 stages, the processor time is printed in nanoseconds per sample 
+                and per stage.
+ */
+void graph_test_benchmark_df1_q15(void)
+{
+    static int16_t coefs[6 * BENCHMARK_DF1_STAGES];
+    static int16_t state[4 * BENCHMARK_DF1_STAGES];
+    static int16_t frame[BENCHMARK_DF1_FRAME];
+    generic_biquad_cascade_df1_inst_q15 filter;
+    uint32_t i, loop, nstages;
+    clock_t start;
+    double seconds;
+
+    for (i = 0; i < BENCHMARK_DF1_STAGES; i++)     /* low-pass, postShift 1 */
+    {   coefs[6*i + 0] = 4000;  coefs[6*i + 1] = 0; coefs[6*i + 2] = 8000;  coefs[6*i + 3] = 4000;
+        coefs[6*i + 4] = -12000;                    coefs[6*i + 5] = 5000;
+    }
+    for (i = 0; i < BENCHMARK_DF1_FRAME; i++)
+    {   frame[i] = (int16_t)(i * 997);
+    }
+
+    for (nstages = 1; nstages <= BENCHMARK_DF1_STAGES; nstages = nstages * 2)
+    {   
+        nanograph_services(PACK_SERVICE(SERV_DSP_INIT, NOOPTION_SSRV, NOTAG_SSRV, SERV_DSP_CASCADE_DF1_Q15, SERV_GROUP_DSP_ML),
+            (intptr_t)&filter, (intptr_t)coefs, (intptr_t)state, (intptr_t)((nstages << 8u) | 1));
+
+        start = clock();
+        for (loop = 0; loop < BENCHMARK_DF1_LOOPS; loop++)
+        {   nanograph_services(PACK_SERVICE(SERV_DSP_RUN, NOOPTION_SSRV, NOTAG_SSRV, SERV_DSP_CASCADE_DF1_Q15, SERV_GROUP_DSP_ML),
+                (intptr_t)&filter, (intptr_t)frame, (intptr_t)frame, (intptr_t)BENCHMARK_DF1_FRAME);
+        }
+        seconds = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+
+        printf("DF1 Q15 %d stages : %.2f ns per sample per stage\n", nstages,
+            1e9 * seconds / ((double)BENCHMARK_DF1_LOOPS * BENCHMARK_DF1_FRAME * nstages));
+    }
+}
+#endif
+
+#ifdef TEST_BIQUAD_F32
+#include <stdio.h>
+#include <math.h>
+
+#define TEST_BIQ_SAMPLES 64                         /* per channel, processed in two calls */
+#define TEST_BIQ_STAGES 2
+#define TEST_BIQ_MAXCHAN 8
+
+/**
+  @brief        Float biquad services (SERV_DSP_CASCADE_DF1_F32 and SERV_DSP_CASCADE_DF2T_F32) 
+                compared with a scalar reference, returns the number of failed checks
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          Two stages filter 1, 5 and 8 interleaved channels (vector lanes of 4 or 8 and 
+                the remaining channels one at a time), the frame is given in two calls to check 
+                the state kept between the calls. The reference is the direct form computed in 
+                double precision channel per channel, both forms must match it within 1e-5.
+ */
+uint32_t graph_test_biquad_f32(void)
+{
+    static const float coefs[5 * TEST_BIQ_STAGES] = 
+    {   0.2f, 0.4f, 0.2f, 0.5f, -0.3f,              /* {b0, b1, b2, a1, a2}, a1 a2 negated */
+        0.6f, -0.2f, 0.1f, -0.4f, -0.25f,
+    };
+    static const uint8_t nchans[] = { 1, 5, TEST_BIQ_MAXCHAN };
+    static const uint8_t services[] = { SERV_DSP_CASCADE_DF1_F32, SERV_DSP_CASCADE_DF2T_F32 };
+    static float frame[TEST_BIQ_SAMPLES * TEST_BIQ_MAXCHAN];
+    static float state[4 * TEST_BIQ_STAGES * TEST_BIQ_MAXCHAN];
+    static double ref[TEST_BIQ_SAMPLES * TEST_BIQ_MAXCHAN];
+    generic_biquad_cascade_df1_inst_f32 filter;
+    const float *c;
+    double x, y, x1, x2, y1, y2;
+    uint32_t i, ich, ichan, iserv, stage, nch, half, fail;
+
+    fail = 0;
+    for (ich = 0; ich < sizeof(nchans); ich++)
+    {   nch = nchans[ich];
+        for (iserv = 0; iserv < sizeof(services); iserv++)
+        {   
+            for (i = 0; i < TEST_BIQ_SAMPLES * nch; i++)
+            {   frame[i] = (float)((int32_t)((i * 2654435761u) >> 16) & 0xFFFF) / 32768.0f - 1.0f;
+                ref[i] = frame[i];
+            }
+
+            /* scalar reference */
+            for (ichan = 0; ichan < nch; ichan++)
+            {   for (stage = 0; stage < TEST_BIQ_STAGES; stage++)
+                {   c = &(coefs[5 * stage]);
+                    x1 = x2 = y1 = y2 = 0;
+                    for (i = 0; i < TEST_BIQ_SAMPLES; i++)
+                    {   x = ref[i * nch + ichan];
+                        y = c[0] * x + c[1] * x1 + c[2] * x2 + c[3] * y1 + c[4] * y2;
+                        ref[i * nch + ichan] = y;
+                        x2 = x1;    x1 = x;
+                        y2 = y1;    y1 = y;
+                    }
+                }
+            }
+
+            nanograph_services(PACK_SERVICE(SERV_DSP_INIT, NOOPTION_SSRV, NOTAG_SSRV, services[iserv], SERV_GROUP_DSP_ML),
+                (intptr_t)&filter, (intptr_t)coefs, (intptr_t)state, (intptr_t)((TEST_BIQ_STAGES << 8u) | nch));
+            half = nch * TEST_BIQ_SAMPLES / 2;
+            nanograph_services(PACK_SERVICE(SERV_DSP_RUN, NOOPTION_SSRV, NOTAG_SSRV, services[iserv], SERV_GROUP_DSP_ML),
+                (intptr_t)&filter, (intptr_t)frame, (intptr_t)frame, (intptr_t)(TEST_BIQ_SAMPLES / 2));
+            nanograph_services(PACK_SERVICE(SERV_DSP_RUN, NOOPTION_SSRV, NOTAG_SSRV, services[iserv], SERV_GROUP_DSP_ML),
+                (intptr_t)&filter, (intptr_t)&(frame[half]), (intptr_t)&(frame[half]), (intptr_t)(TEST_BIQ_SAMPLES / 2));
+
+            for (i = 0; i < TEST_BIQ_SAMPLES * nch; i++)
+            {   if (fabs((double)frame[i] - ref[i]) > 1e-5)
+                {   fail++;
+                    break;
+                }
+            }
+        }
+    }
+
+    printf("float biquads : DF1 and DF2T, 1 5 8 channels, %d failed checks\n", fail);
+    return fail;
+}
+#endif
+
+#ifdef STRESS_ARC_SPSC
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define STRESS_ARC_FRAME  48        /* not a divider of the buffer : the realignments are exercised */
+#define STRESS_ARC_FRAMES 2000000
+#define STRESS_ARC_RX     0         /* IO indexes in different bytes of ongoing_async_IO[] */
+#define STRESS_ARC_TX     8
+
+/**
+  @brief        producer thread of the stress test, the "IO interrupt"
+  @param[in]    arg     instance of the test graph
+  @return       none
+
+  @par          The frames carry an incrementing word counter. The thread owns the write index,
+                it waits for free space and for the end of the realignment (ALIGNBLCK_ARCW3) 
+                before calling NanoGraph_io_ack(), no frame is dropped.
+ */
+static void *stress_arc_producer (void *arg)
+{
+    nanograph_instance_t *S = (nanograph_instance_t *)arg;
+    uint32_t frame[STRESS_ARC_FRAME / 4], n, i, wr_w32, counter;
+
+    counter = 0;
+    for (n = 0; n < STRESS_ARC_FRAMES; )
+    {   wr_w32 = ARC_WR_LOAD(S, 0);
+        if (TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB) ||
+            ARC_SIZE(S, 0) - ARC_WRITE_W32(S, 0, wr_w32) < STRESS_ARC_FRAME)
+        {   sched_yield();
+            continue;
+        }
+        for (i = 0; i < STRESS_ARC_FRAME / 4; i++)
+        {   frame[i] = counter++;
+        }
+        NanoGraph_io_ack(STRESS_ARC_RX, frame, STRESS_ARC_FRAME);
+        n++;
+    }
+    return 0;
+}
+
+/**
+  @brief        Stress test of the single-producer single-consumer protocol of the arcs
+  @param[in]    none
+  @return       none
+
+  @par          A producer thread writes frames in an arc with RX acknowledges, this thread
+                consumes them with TX acknowledges. The consumer realigns the arc when the 
+                producer sets ALIGNBLCK_ARCW3. Every word received is checked against the 
+                counter of the producer, the errors and the flow errors are printed.
+ */
+void graph_test_stress_arc_spsc(void)
+{
+    nanograph_instance_t *S;
+    pthread_t producer;
+    uint32_t frame[STRESS_ARC_FRAME / 4], n, i, counter, errors;
+
+    S = graph_test_enter();
+    graph_test_arc(0, 1024, STRESS_ARC_FRAME, 0);
+    graph_test_io(STRESS_ARC_RX, 0, 0, 0);
+    graph_test_io(STRESS_ARC_TX, 0, 1, 0);
+    pthread_create(&producer, 0, stress_arc_producer, S);
+
+    counter = errors = 0;
+    for (n = 0; n < STRESS_ARC_FRAMES; )
+    {   if (ARC_WRITE(S, 0) - ARC_READ(S, 0) < STRESS_ARC_FRAME)
+        {   sched_yield();
+            continue;
+        }
+        NanoGraph_io_ack(STRESS_ARC_TX, frame, STRESS_ARC_FRAME);
+        for (i = 0; i < STRESS_ARC_FRAME / 4; i++)
+        {   if (frame[i] != counter++)
+            {   errors++;
+                counter = frame[i] + 1;
+            }
+        }
+        n++;
+    }
+    pthread_join(producer, 0);
+
+    printf("arc SPSC stress : %d frames, %d errors, %d overflows %d underflows\n",
+        (int)n, (int)errors, (int)S->arc_flow_errors[OVERFLOW_FLOWCNT], (int)S->arc_flow_errors[UNDERFLOW_FLOWCNT]);
+    graph_test_leave();
+}
+#endif
+
+#ifdef STRESS_DMA_PINGPONG
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+extern void io_audio_in_0 (uint32_t command, nanograph_xdmbuffer_t *data);
+
+#define STRESS_DMA_HALF   96        /* size_audio_in_0 of platform_io_services.c */
+#define STRESS_DMA_FRAME  AUDIOINFRAMESIZE
+#define STRESS_DMA_HALVES 200000
+
+static uint32_t stress_dma_consumed;    /* halves given back to the DMA by the graph */
+
+/**
+  @brief        DMA thread of the ping-pong test, the "audio interrupt"
+  @param[in]    arg     unused
+  @return       none
+
+  @par          The frames carry an incrementing word counter and are given to io_audio_in_0_dma().
+                Before writing in a half the thread waits for the graph to give back the previous 
+                content of this half, and before completing it (transfer interrupt) for the graph 
+                to give back the other half : the DMA never misses its deadline and fills one half 
+                while the graph reads the other.
+ */
+static void *stress_dma_thread (void *arg)
+{
+    uint32_t frame[STRESS_DMA_FRAME / 4], posted, fill, last, i, counter;
+
+    counter = 0;
+    for (posted = 0; posted < STRESS_DMA_HALVES; posted++)
+    {   for (fill = 0; fill < STRESS_DMA_HALF; fill += STRESS_DMA_FRAME)
+        {   last = (fill + STRESS_DMA_FRAME >= STRESS_DMA_HALF) ? 1u : 0u;
+            while (ARC_LOAD_ACQUIRE(stress_dma_consumed) + 1u < posted + last)
+            {   sched_yield();
+            }
+            for (i = 0; i < STRESS_DMA_FRAME / 4; i++)
+            {   frame[i] = counter++;
+            }
+            io_audio_in_0_dma((const uint8_t *)frame, STRESS_DMA_FRAME);
+        }
+    }
+    return 0;
+}
+
+/**
+  @brief        Stress test of the ownership of the ping-pong halves of audio_in_0
+  @param[in]    none
+  @return       number of errors
+
+  @par          A thread emulates the DMA, this thread is the graph : it drains the acknowledges 
+                posted by the DMA interrupts and reads the half given to the arc in place 
+                (IO_COMMAND_SET_BUFFER). The half is read twice with a yield in between : a 
+                write of the DMA in the half owned by the graph, a half given twice, or a half 
+                not consumed when the next one arrives (overflow) is an error.
+                With IO_ACK_QUEUE a direct NanoGraph_io_ack() of the in-place IO must not rebase 
+                the arc before the scheduler drains it, a frame in two segments is rejected.
+ */
+uint32_t graph_test_stress_dma_pingpong(void)
+{
+    nanograph_instance_t *S;
+    nanograph_xdmbuffer_t xdm;
+    pthread_t dma;
+    uint32_t *half, *previous, n, i, pass, counter, errors;
+
+    S = graph_test_enter();
+    graph_test_arc(0, STRESS_DMA_HALF, STRESS_DMA_HALF, 0);
+    graph_test_io(IO_PLATFORM_AUDIO_IN_0, 0, 0, 0);
+    ST(S->pio_graph[NANOGRAPH_IOFMT_SIZE_W32 * IO_PLATFORM_AUDIO_IN_0], SET0COPY1_IOFMT0, IO_COMMAND_SET_BUFFER);
+    xdm.address = 0;
+    xdm.size = 0;
+    io_audio_in_0(NANOGRAPH_SET_BUFFER, &xdm);
+    counter = errors = 0;
+
+#ifdef IO_ACK_QUEUE
+    /* the rebase is made by the scheduler, not in the context of the IO */
+    {   extern void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+        static uint32_t direct[STRESS_DMA_HALF / 4];
+        uint8_t *base = ARC_BASE(S, 0);
+
+        NanoGraph_io_ack(IO_PLATFORM_AUDIO_IN_0, direct, STRESS_DMA_HALF);
+        if (ARC_BASE(S, 0) != base || ARC_WRITE(S, 0) != 0)
+        {   errors++;
+        }
+        io_ack_drain(S);
+        if (ARC_BASE(S, 0) != (uint8_t *)direct || ARC_WRITE(S, 0) != STRESS_DMA_HALF)
+        {   errors++;
+        }
+        ARC_ST_READ(S, 0, ARC_WRITE(S, 0));
+
+        /* a frame in two segments can't be mapped in place : rejected, the arc keeps its buffer */
+        {   extern void NanoGraph_io_ackv (uint8_t graph_hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments);
+            nanograph_io_segment_t seg[2];
+
+            seg[0].data = direct;
+            seg[0].size = STRESS_DMA_HALF / 2;
+            seg[1].data = &(direct[STRESS_DMA_HALF / 8]);
+            seg[1].size = STRESS_DMA_HALF / 2;
+            NanoGraph_io_ackv(IO_PLATFORM_AUDIO_IN_0, seg, 2);
+            io_ack_drain(S);
+            if (ARC_BASE(S, 0) != (uint8_t *)direct || ARC_READ(S, 0) != ARC_WRITE(S, 0) || 
+                S->arc_flow_errors[OVERFLOW_FLOWCNT] != 1)
+            {   errors++;
+            }
+            S->arc_flow_errors[OVERFLOW_FLOWCNT] = 0;
+        }
+    }
+#endif
+    stress_dma_consumed = 0;
+    pthread_create(&dma, 0, stress_dma_thread, 0);
+
+    previous = 0;
+    for (n = 0; n < STRESS_DMA_HALVES; )
+    {
+#ifdef IO_ACK_QUEUE
+        io_ack_drain(S);
+#endif
+        if (ARC_WRITE(S, 0) - ARC_READ(S, 0) < STRESS_DMA_HALF)
+        {   sched_yield();
+            continue;
+        }
+        half = (uint32_t *)(ARC_BASE(S, 0) + ARC_READ(S, 0));
+        if (half == previous)                   /* the halves alternate */
+        {   errors++;
+        }
+        for (pass = 0; pass < 2; pass++)        /* the DMA fills the other half meanwhile */
+        {   for (i = 0; i < STRESS_DMA_HALF / 4; i++)
+            {   if (half[i] != counter + i)
+                {   errors++;
+                    break;
+                }
+            }
+            sched_yield();
+        }
+        counter += STRESS_DMA_HALF / 4;
+        previous = half;
+        ARC_ST_READ(S, 0, ARC_WRITE(S, 0));
+        n++;
+        ARC_STORE_RELEASE(stress_dma_consumed, n);
+    }
+    pthread_join(dma, 0);
+
+    errors += S->arc_flow_errors[OVERFLOW_FLOWCNT];
+    printf("DMA ping-pong stress : %d halves, %d errors, %d overflows\n",
+        (int)n, (int)errors, (int)S->arc_flow_errors[OVERFLOW_FLOWCNT]);
+    graph_test_leave();
+    return errors;
+}
+#endif
+
+#ifdef TEST_2D_BANDS
+#include <stdio.h>
+
+extern void io_2d_in_0 (uint32_t command, nanograph_xdmbuffer_t *data);
+
+#define TEST_2D_LINE    40      /* bytes of a camera line, the lines straddle the bands */
+#define TEST_2D_BAND    96      /* size_2d_in_0 of platform_io_services.c */
+#define TEST_2D_NBANDS  5       /* bands per image, I2D_BANDS_FMT3 of the consumer format */
+#define TEST_2D_IMAGES  3
+
+/**
+  @brief        Test of the line-band streaming of 2d_in_0 with a band consumer
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          The lines of the camera are given to io_2d_in_0_line(), a line straddling two 
+                bands is split between them. The consumer reads I2D_BANDS_FMT3 in its format, 
+                takes the arc band after band, counts the bands of each image and checks the 
+                pixels : an image is TEST_2D_NBANDS bands, the pixels are a byte counter.
+ */
+uint32_t graph_test_2d_bands(void)
+{
+    nanograph_instance_t *S;
+    nanograph_xdmbuffer_t xdm;
+    uint8_t line[TEST_2D_LINE], *band;
+    uint32_t *fmt, nbands, iband, images, offset, nline, i, wr_w32, fail = 0;
+
+    S = graph_test_enter();
+    graph_test_arc(0, 4 * TEST_2D_BAND, TEST_2D_BAND, 0);
+    fmt = &(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(ARC_DESC(S, 0)[FMT_ARCW4], CONSUMFMT_ARCW4)]);
+    ST(fmt[DOMAINSPECIFIC_FMT3], I2D_BANDS_FMT3, TEST_2D_NBANDS);
+    graph_test_io(IO_PLATFORM_2D_IN_0, 0, 0, 0);
+    io_2d_in_0(NANOGRAPH_RESET, &xdm);
+
+    iband = images = offset = 0;
+    for (nline = 0; nline < TEST_2D_IMAGES * TEST_2D_NBANDS * TEST_2D_BAND / TEST_2D_LINE; nline++)
+    {   for (i = 0; i < TEST_2D_LINE; i++)
+        {   line[i] = (uint8_t)((nline * TEST_2D_LINE + i) % 251);
+        }
+        io_2d_in_0_line(line, TEST_2D_LINE);
+#ifdef IO_ACK_QUEUE
+        io_ack_drain(S);
+#endif
+
+        /* band consumer */
+        nbands = RD(fmt[DOMAINSPECIFIC_FMT3], I2D_BANDS_FMT3);
+        while (ARC_WRITE(S, 0) - ARC_READ(S, 0) >= TEST_2D_BAND)
+        {   band = ARC_BASE(S, 0) + ARC_READ(S, 0);
+            for (i = 0; i < TEST_2D_BAND; i++, offset++)
+            {   if (band[i] != (uint8_t)(offset % 251))
+                {   fail++;
+                    offset += TEST_2D_BAND - i;
+                    break;
+                }
+            }
+            ARC_ST_READ(S, 0, ARC_READ(S, 0) + TEST_2D_BAND);
+            if (++iband == nbands)
+            {   iband = 0;
+                images++;
+            }
+        }
+
+        /* the producer asks for the realignment, the arc is empty */
+        wr_w32 = ARC_WR_LOAD(S, 0);
+        if (TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB) && ARC_READ(S, 0) == ARC_WRITE_W32(S, 0, wr_w32))
+        {   ARC_ST_READ(S, 0, 0);
+            ARC_ST_WRITE(S, 0, wr_w32, 0)
+            CLEAR_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
+            ARC_WR_STORE(S, 0, wr_w32);
+        }
+    }
+    if (images != TEST_2D_IMAGES || iband != 0 || S->arc_flow_errors[OVERFLOW_FLOWCNT] != 0)
+    {   fail++;
+    }
+
+    printf("2D bands : %d images of %d bands, %d failed checks\n", (int)images, TEST_2D_NBANDS, (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
+#if defined(TEST_SHM_IO) && defined(PLATFORM_SHM_IO)
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+extern void io_data_in_1 (uint32_t command, nanograph_xdmbuffer_t *data);
+extern void io_data_out_1 (uint32_t command, nanograph_xdmbuffer_t *data);
+extern uint32_t io_shm_poll (void);
+
+#define TEST_SHM_MAGIC  0x4E475348u     /* SHM_IO_MAGIC of platform_io_services.c */
+#define TEST_SHM_FRAME  32              /* frames of io_data_out_1 */
+
+/* ring of platform_io_services.c seen by the other process : 32 bytes header and the frames */
+typedef struct 
+{   uint32_t magic, frame_bytes, nb_frames, write, read, reserved[3];
+    uint8_t frame[SHM_IO_FRAMES][SHM_IO_FRAME_BYTES];
+} test_shm_ring_t;
+
+/**
+  @brief        map a ring as the other process
+  @param[in]    name    POSIX shared-memory name
+  @param[in]    size    size of a new object
+  @return       the mapping
+ */
+static test_shm_ring_t *test_shm_peer (const char *name, uint32_t size)
+{
+    test_shm_ring_t *ring;
+    int fd;
+
+    fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+    if (fd < 0 || 0 != ftruncate(fd, size))
+    {   return 0;
+    }
+    ring = (test_shm_ring_t *)mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return (ring == MAP_FAILED) ? 0 : ring;
+}
+
+/**
+  @brief        Test of the shared-memory IOs with a stub of the other process
+  @param[in]    none
+  @return       number of failed checks
+
+  @par          This thread plays the other process with its own mapping of the rings. A ring 
+                opened twice is cleared once, a ring with another geometry is not attached. 
+                io_data_in_1 gives the frames in place and releases the held frame with the next 
+                one, io_data_out_1 copies the frames of the graph and waits for a free frame : 
+                the requests stay pending while the other process is late.
+ */
+uint32_t graph_test_shm_io(void)
+{
+    nanograph_instance_t *S;
+    nanograph_xdmbuffer_t xdm;
+    test_shm_ring_t *in, *out;
+    uint32_t i, wr_w32, fail = 0;
+
+    S = graph_test_enter();
+    shm_unlink(SHM_DATA_IN_1);
+    shm_unlink(SHM_DATA_OUT_1);
+
+    /* another geometry : not attached, no buffer given to the graph */
+    in = test_shm_peer(SHM_DATA_IN_1, sizeof(test_shm_ring_t));
+    in->frame_bytes = SHM_IO_FRAME_BYTES;
+    in->nb_frames = SHM_IO_FRAMES + 1;
+    ARC_STORE_RELEASE(in->magic, TEST_SHM_MAGIC);
+    xdm.address = 0;
+    io_data_in_1(NANOGRAPH_RESET, &xdm);
+    io_data_in_1(NANOGRAPH_SET_BUFFER, &xdm);
+    if (xdm.address != 0)
+    {   fail++;
+    }
+    munmap(in, sizeof(test_shm_ring_t));
+    shm_unlink(SHM_DATA_IN_1);
+
+    /* the first opening clears the ring, the second attaches without clearing */
+    io_data_in_1(NANOGRAPH_RESET, &xdm);
+    in = test_shm_peer(SHM_DATA_IN_1, sizeof(test_shm_ring_t));
+    if (in->magic != TEST_SHM_MAGIC || in->nb_frames != SHM_IO_FRAMES || in->frame_bytes != SHM_IO_FRAME_BYTES)
+    {   fail++;
+    }
+    in->frame[0][0] = 0x5A;
+    ARC_STORE_RELEASE(in->write, 1);
+    io_data_in_1(NANOGRAPH_STOP, &xdm);
+    io_data_in_1(NANOGRAPH_RESET, &xdm);
+    if (in->write != 1)
+    {   fail++;
+    }
+
+    /* io_data_in_1 : frames read in place, the held frame is released with the next one */
+    graph_test_arc(0, SHM_IO_FRAME_BYTES, SHM_IO_FRAME_BYTES, 0);
+    graph_test_io(IO_PLATFORM_DATA_IN_1, 0, 0, 0);
+    ST(S->pio_graph[NANOGRAPH_IOFMT_SIZE_W32 * IO_PLATFORM_DATA_IN_1], SET0COPY1_IOFMT0, IO_COMMAND_SET_BUFFER);
+    io_data_in_1(NANOGRAPH_RUN, &xdm);
+#ifdef IO_ACK_QUEUE
+    io_ack_drain(S);                                /* the in-place rebase is made by the scheduler */
+#endif
+    in->frame[0][1] = 0x33;                         /* seen by the graph : the frame is read in place */
+    if (ARC_WRITE(S, 0) != SHM_IO_FRAME_BYTES || ARC_BASE(S, 0)[0] != 0x5A || ARC_BASE(S, 0)[1] != 0x33 || in->read != 0)
+    {   fail++;
+    }
+    ARC_ST_READ(S, 0, ARC_WRITE(S, 0));
+    io_data_in_1(NANOGRAPH_RUN, &xdm);              /* the other process is late */
+    if (0 != io_shm_poll() || in->read != 0)
+    {   fail++;
+    }
+    in->frame[1][0] = 0xA5;
+    ARC_STORE_RELEASE(in->write, 2);
+    if (1 != io_shm_poll() || in->read != 1)
+    {   fail++;
+    }
+#ifdef IO_ACK_QUEUE
+    io_ack_drain(S);
+#endif
+    if (ARC_BASE(S, 0)[0] != 0xA5)
+    {   fail++;
+    }
+
+    /* io_data_out_1 : frames copied to the ring, pending on a full ring */
+    io_data_out_1(NANOGRAPH_RESET, &xdm);
+    out = test_shm_peer(SHM_DATA_OUT_1, sizeof(test_shm_ring_t));
+    graph_test_arc(1, TEST_SHM_FRAME * (SHM_IO_FRAMES + 1), TEST_SHM_FRAME, 0);
+    graph_test_io(IO_PLATFORM_DATA_OUT_1, 1, 1, 0);
+    for (i = 0; i < TEST_SHM_FRAME * (SHM_IO_FRAMES + 1); i++)
+    {   ARC_BASE(S, 1)[i] = (uint8_t)(i / TEST_SHM_FRAME);
+    }
+    wr_w32 = ARC_WR_LOAD(S, 1);
+    ARC_ST_WRITE(S, 1, wr_w32, TEST_SHM_FRAME * (SHM_IO_FRAMES + 1))
+    ARC_WR_STORE(S, 1, wr_w32);
+    xdm.size = TEST_SHM_FRAME;
+    for (i = 0; i < SHM_IO_FRAMES; i++)
+    {   io_data_out_1(NANOGRAPH_RUN, &xdm);
+    }
+    if (out->write != SHM_IO_FRAMES || out->frame[SHM_IO_FRAMES - 1][0] != SHM_IO_FRAMES - 1)
+    {   fail++;
+    }
+    io_data_out_1(NANOGRAPH_RUN, &xdm);             /* full ring */
+    if (0 != io_shm_poll() || out->write != SHM_IO_FRAMES)
+    {   fail++;
+    }
+    ARC_STORE_RELEASE(out->read, 1);
+    if (1 != io_shm_poll() || out->write != SHM_IO_FRAMES + 1 || out->frame[0][0] != SHM_IO_FRAMES)
+    {   fail++;
+    }
+
+    io_data_in_1(NANOGRAPH_STOP, &xdm);
+    io_data_out_1(NANOGRAPH_STOP, &xdm);
+    munmap(in, sizeof(test_shm_ring_t));
+    munmap(out, sizeof(test_shm_ring_t));
+    shm_unlink(SHM_DATA_IN_1);
+    shm_unlink(SHM_DATA_OUT_1);
+
+    printf("shared-memory IO : %d failed checks\n", (int)fail);
+    graph_test_leave();
+    return fail;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
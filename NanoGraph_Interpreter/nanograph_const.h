@@ -159,6 +159,12 @@
 #define RSTSTATE_DONE           2u  /* state = 2 : reset done, IO init done (NANOGRAPH_MAIN_INSTANCE), graph RAM copied (GLOBAL_MAIN_INSTANCE) */
 #define RSTSTATE_DONE_SYNC      3u  /* state = 1 : reset completed for all instances */
 
+#define ERROR_LOG_NB_ARCS       1u  /* error_log : more arcs than MAX_NB_ARCS in the graph, the instance stays in reset */
+#define ERROR_LOG_IO_ARC        2u  /* error_log : an IO of the graph is connected to an arc index above the arcs of the graph */
+#define ERROR_LOG_HISTORY       4u  /* error_log : an arc format is out of the table of formats, or the history leaves no room for a producer frame */
+#define ERROR_LOG_ARC_FMT       8u  /* error_log : an arc of the graph is connected to a format index above the formats of the graph */
+#define ERROR_LOG_IO_BUFFER    16u  /* error_log : an in-place IO has no buffer to give to its arc (IO_COMMAND_SET_BUFFER) */
+
 #define    INST_ID_SCTRL_MSB U(31)  /*  from [A]pp [P]latform [S} scheduler */
 #define     WHOAMI_SCTRL_MSB U(31)
 #define   PRIORITY_SCTRL_MSB U(31)  /*   different RTOS instances*/
@@ -844,13 +850,21 @@
 /*  the stream consumer check the time-stamps and rejects the data outside of a predefined time-window */
 
 /*
-*   Flow error management with FLOW_RD_ARCW2 / FLOW_WR_ARCW2 = let an arc stay with 25% .. 75% of data
+*   Flow error management with FLOW_RD_IOFMT1 / FLOW_WR_IOFMT1 of the IO master interfaces
+*       NanoGraph_io_ack() applies the correction when the arc is full (RX) or empty (TX), the
+*       events are counted in S->arc_flow_errors[] (OVERFLOW_FLOWCNT, UNDERFLOW_FLOWCNT).
+*       Crossfades are made on S16/S32/FP32 frames, other formats are copied or cleared.
+*       The published data of the arc is never modified : the RX frame lost on an overflow is
+*       replaced by a fade-in of the next frame from the last sample of the arc (interleaved 
+*       frames), the TX frame repeated on an underflow is faded-out in the buffer of the IO.
+* 
+*   Target scheme, let an arc stay with 25% .. 75% of data
 *       process done on "router" node when using HQOS arc and IO master interfaces
 * 
 *  The arc is initialized with 50% of null data
 *  The processing is frame-based, there are minimum 3 frames in the buffer
 
-*   When a IO-master writes in an arc with FLOW_WR_ARCW2=1 and the arc is full at +75%, the new data 
+*   When a IO-master writes in an arc with FLOW_WR_IOFMT1=1 and the arc is full at +75%, the new data 
 *       is extrapolated and the arc stays at 75% full 
 *      Buff  xxxxxxxx|xxxx|xxxx|xxxx|bbbb|aaaa|  buffer full after NewData was push by the IO-master
 *              R_ptr                      W_ptr
@@ -859,7 +873,7 @@
 *            xxxxxxxx|xxxx|xxxx|xxxx|bbaa|----|  buffer full
 *              R_ptr                      W_ptr
 * 
-*   When a IO-master read from an arc with FLOW_RD_ARCW2=1 and the arc is empty at -25%, the new data 
+*   When a IO-master read from an arc with FLOW_RD_IOFMT1=1 and the arc is empty at -25%, the new data 
 *       is extrapolated and the arc stays at 25% empty
 * 
 *      Buff  |bbbb| is read by the IO-master
@@ -871,6 +885,125 @@
 *             R_ptr      W_ptr
 */
 
+/*
+*   Planar arcs (ARC_PLANAR, PLANAR_ARCW4) : the consumer format is FMT_DEINTERLEAVED_PLANAR, the R/W 
+*       indexes count the bytes of all the channels, the plane of each channel holds index / nchan bytes.
+*       The node receives in xdm_data[].address a table of MAX_NB_PLANAR_CHANNELS pointers (one per 
+*       channel) and xdm_data[].size in bytes of all the channels.
+*/
+#ifdef ARC_PLANAR
+#define ARC_IS_PLANAR(arc) TEST_BIT((arc)[FMT_ARCW4], PLANAR_ARCW4_LSB)
+#else
+#define ARC_IS_PLANAR(arc) 0u
+#endif
+#define PLANE_ALIGNMENT_BYTES ((CACHE_LINE_BYTE_LENGTH > 16) ? CACHE_LINE_BYTE_LENGTH : 16)
+
+/* number of channels of the consumer format of an arc */
+#define ARC_NCHAN(S,arc) (RD((S)->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD((arc)[FMT_ARCW4],CONSUMFMT_ARCW4) + NCHANDOMAIN_FMT1], NCHANM1_FMT1) + 1)
+
+#define NEARFULL_WMARK_MSB U(31) /*     occupancy watermarks, one word per arc (ARC_WATERMARKS) */
+#define NEARFULL_WMARK_LSB U(24) /*  8  updates leaving less than one producer frame of free space, saturated */
+#define     PEAK_WMARK_MSB U(23) /*     */
+#define     PEAK_WMARK_LSB U( 0) /* 24  peak occupancy in bytes */
+
+#define ARC_GROW_NEARFULL 16u   /* NEARFULL_WMARK threshold of ARC_AUTO_GROW */
+
+/*
+*   Time-stamp rings (ARC_TIMESTAMPS) : one ring per arc, the IO pushes {stream position, time} 
+*       for each frame received on an arc where the consumer format has TIMSTAMP_FMT1 != NO_TIMESTAMP.
+*       The stream positions count the bytes written/read since reset, they do not change with the 
+*       realignments of the buffer. Before the node call the scheduler finds the frame holding the 
+*       byte at the read index and gives its time-stamp and the byte distance to it in the 
+*       nanograph_xdm_frame_t tables following xdm_data[] (FRAME_COUNTER streams give the frame index).
+*/
+#define WRPOS_ARCTSTP       0u  /* stream position of the write index, updated by the IO */
+#define RDPOS_ARCTSTP       1u  /* stream position of the read index, updated by the scheduler */
+#define NPUSH_ARCTSTP       2u  /* number of frames pushed in the ring */
+#define RING_ARCTSTP        3u  /* ARC_TSTP_RING pairs {stream position of the frame, time-stamp} */
+#define SIZEOF_ARCTSTP_W32 (RING_ARCTSTP + 2u * ARC_TSTP_RING)
+
+/*
+*   IO coalescing (IO_COALESCING, COALESCE_IOFMT1) : the RX data is copied after the write index 
+*       without publishing it, until the arc holds one consumer frame or the timeout of the first 
+*       staged acknowledge is passed. The timeout is checked on the acknowledges and by the 
+*       scheduler (io_coalesce_timeout), which publishes the data of an IO with no new acknowledge.
+*/
+#define STAGED_ARCSTG       0u  /* bytes copied after the write index, not published */
+#define DEADLINE_ARCSTG     1u  /* publication time at the latest, q12.20 [s] */
+#define SIZEOF_ARCSTG_W32   2u
+#define COALESCE_Q20(ms) ((ms) * 1049u)     /* [ms] to q12.20 [s] */
+
+/*
+*   Clock drift compensation (IO_DRIFT_COMPENSATION, DRIFTCOMP_IOFMT1) : on each acknowledge the 
+*       occupancy of the IO arc is low-pass filtered and a PI controller updates the resampling 
+*       step (input samples per output sample) to keep the arc half full. The IO data is resampled 
+*       with linear interpolation, interleaved S16/S32/FP32 streams, up to DRIFT_MAX_CHANNELS.
+*/
+#define PHASE_DRIFT         0u  /* position of the next output after the history sample, Q28, below 2.0 */
+#define STEP_DRIFT          1u  /* resampling step, Q28 */
+#define FILL_DRIFT          2u  /* filtered occupancy error, Q16 of the buffer size */
+#define INTEG_DRIFT         3u  /* integral term of the controller, Q28 */
+#define HIST_DRIFT          4u  /* last input sample of each channel */
+#define DRIFT_MAX_CHANNELS  8u
+#define SIZEOF_ARCDRIFT_W32 (HIST_DRIFT + DRIFT_MAX_CHANNELS)
+
+#define DRIFT_UNITY     (1u << 28)
+#define DRIFT_MAX_STEP  536871      /* +/-2000 ppm in Q28 */
+#define DRIFT_LPF_SHIFT 4           /* occupancy low-pass filter */
+#define DRIFT_KP_SHIFT  4           /* proportional gain, Q16 error to Q28 step */
+#define DRIFT_KI_SHIFT  6           /* integral gain per acknowledge */
+
+/*
+*   IO record (IO_RECORD) : the requests of the scheduler to the servant IOs and the acknowledges 
+*       of the IOs are given to platform_io_record() with their data, see nanograph_io_event_t. 
+*       The acknowledges posted by ISRs are recorded when posted, not when drained.
+*/
+#define IO_EVENT_REQUEST    0u  /* NANOGRAPH_RUN from check_graph_boundaries(), size requested */
+#define IO_EVENT_ACK        1u  /* NanoGraph_io_ack(), NanoGraph_io_ackv() */
+#define IO_EVENT_POST       2u  /* NanoGraph_io_ack_post() */
+#define IO_RECORD_MAGIC     0x4F49474Eu  /* "NGIO" */
+
+#ifdef IO_RECORD
+#define IO_RECORD_EVENT(kind,idx,segment,nseg) platform_io_record((kind),(idx),(segment),(nseg))
+#else
+#define IO_RECORD_EVENT(kind,idx,segment,nseg) ((void)(segment))    /* the segment is not left set but unused */
+#endif
+
+/* time-stamp format of the consumer of an arc (NO_TIMESTAMP, FRAME_COUNTER, ..) */
+#define ARC_TSTP_TYPE(S,arc) RD((S)->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD((arc)[FMT_ARCW4],CONSUMFMT_ARCW4) + NCHANDOMAIN_FMT1], TIMSTAMP_FMT1)
+
+#ifdef ARC_WATERMARKS
+#define ARC_WATERMARK(S,iarc,occupancy,nearfull) arc_watermark_update((S),(iarc),(occupancy),(nearfull))
+#else
+#define ARC_WATERMARK(S,iarc,occupancy,nearfull)
+#endif
+#if defined(ARC_AUTO_GROW) && !defined(ARC_WATERMARKS)
+#error "ARC_AUTO_GROW decides from the NEARFULL_WMARK counts, define ARC_WATERMARKS"
+#endif
+#if defined(IO_COALESCING) && !defined(IO_ACK_QUEUE)
+#error "IO_COALESCING publishes the staged data from the scheduler, the IOs post their acknowledges (IO_ACK_QUEUE)"
+#endif
+#if defined(IO_ACK_QUEUE) && ((IO_ACK_QUEUE) < 2 || ((IO_ACK_QUEUE) & ((IO_ACK_QUEUE) - 1)) != 0)
+#error "the slot of the posted acknowledges is counter & (IO_ACK_QUEUE - 1), IO_ACK_QUEUE must be a power of 2"
+#endif
+
+/* header bytes added to the producer frame of message arcs */
+#define ARC_MSG_OVERHEAD(arc) (TEST_BIT((arc)[FMT_ARCW4], MESSAGE_ARCW4_LSB) ? MSG_HEADER_BYTES : 0u)
+
+#define FLOW_RD_NO_ACTION               0u      /* FLOW_RD_IOFMT1 */
+#define FLOW_RD_REPEAT_FADE             1u
+#define FLOW_RD_NULL_FRAME              2u
+#define FLOW_WR_NO_ACTION               0u      /* FLOW_WR_IOFMT1 */
+#define FLOW_WR_CROSSFADE               1u
+
+#define SIZEOF_FLOWCNT_W32      U(2)    /* counters of flow errors, two words per arc, one writer per word */
+#define  OVERFLOW_FLOWCNT       U(0)    /* written by the RX acknowledges (producer of the arc) */
+#define UNDERFLOW_FLOWCNT       U(1)    /* written by the TX acknowledges (consumer of the arc) */
+#define    XFADE_FLOWCNT_MSB U(31) /*     OVERFLOW_FLOWCNT word : the next RX frame is faded-in from the */
+#define    XFADE_FLOWCNT_LSB U(31) /*  1  last sample of the arc (FLOW_WR_CROSSFADE) */
+#define    COUNT_FLOWCNT_MSB U(30) /*     */
+#define    COUNT_FLOWCNT_LSB U( 0) /* 31  number of events, saturated */
+
 #define arc_read_address                1u
 #define arc_write_address               2u
 #define arc_data_amount                 3u
@@ -907,8 +1040,10 @@
 #define   MPFLUSH_CTRL0     1     /*  reload/flush buffer and arc descriptor */
 
 #define          SIZE_ARCW1    U(1 + CACHE_LINE_BYTE_LENGTH/4)
-#define    unused_ARCW1_MSB U(31) /*     */
-#define    unused_ARCW1_LSB U(26) /*  6  */
+/*  byte 3 is the node state byte (COLLISION2CTRL_BYTES from the collision byte) updated by the scheduler
+    with byte accesses, it does not hold configuration bits of the arc */
+#define NODESTATE_ARCW1_MSB U(31) /*     node state byte, reserved */
+#define NODESTATE_ARCW1_LSB U(26) /*  6  */
 #define RESETDONE_ARCW1_MSB U(25) /*     */
 #define RESETDONE_ARCW1_LSB U(25) /*  1  */
 #define NEW_PARAM_ARCW1_MSB U(24) /*     */
@@ -932,7 +1067,9 @@
 
 #define            WR_ARCW3    U(3)    
 #define    unused_ARCW3_MSB U(31) /*     */
-#define    unused_ARCW3_LSB U(25) /*  7  */
+#define    unused_ARCW3_LSB U(26) /*  6  */
+#define   EXTDESC_ARCW3_MSB U(25) /*     extended arc (ARC_EXTENDED) : 32-bit size and R/W indexes in S->arc_extended */
+#define   EXTDESC_ARCW3_LSB U(25) /*  1  BUFF_SIZE is in SIZE_EXT_FMT0 format, READ/WRITE are the initial indexes */
 #define ALIGNBLCK_ARCW3_MSB U(24) /*     producer blocked sets "I need data realignement from the consumer because the buffer is full" */
 #define ALIGNBLCK_ARCW3_LSB U(24) /*  1   a full buffer can have the Write index = BUFF_SIZE, there is no space lost */
 #define     WRITE_ARCW3_MSB SIZE_EXT_FMT0_MSB /*    write pointer is incremented by FRAMESIZE_FMT0 */
@@ -941,8 +1078,12 @@
 
 #define             FMT_ARCW4   U(4)
 #define unused____ARCW4_MSB U(31) /*       */ 
-#define unused____ARCW4_LSB U(24) /*  6    */
-#define SCRIPTSEL_ARCW4_MSB U(31) /*     Script activated on R1/W2/Both3/Never0  */ 
+#define unused____ARCW4_LSB U(28) /*  4    */
+#define   MESSAGE_ARCW4_MSB U(27) /*     1: arc of length-prefixed messages (MSG_HEADER_BYTES), ready for read with one */
+#define   MESSAGE_ARCW4_LSB U(27) /*  1  message, the producer frame size is the largest payload */
+#define    PLANAR_ARCW4_MSB U(26) /*     1: one plane per channel, set at reset (ARC_PLANAR) from the consumer format */
+#define    PLANAR_ARCW4_LSB U(26) /*  1  FMT_DEINTERLEAVED_PLANAR, planes spaced by BUFF_SIZE / nchan (PLANE_ALIGNMENT_BYTES) */
+#define SCRIPTSEL_ARCW4_MSB U(25) /*     Script activated on R1/W2/Both3/Never0  */ 
 #define SCRIPTSEL_ARCW4_LSB U(24) /*  2    */
 #define    SCRIPT_ARCW4_MSB U(23) /*     log timestamps , wakeup instance application callback */
 #define    SCRIPT_ARCW4_LSB U(16) /*  8  peak detection , arc synchronicity RX/TX , script from Timer's ticks */
@@ -952,6 +1093,140 @@
 #define PRODUCFMT_ARCW4_LSB U( 0) /*    Graph generator gives IN/OUT arc's frame size to be the LCM of NODE "grains" */
 
 
+/*
+    ARC_HOT_COLD_SPLIT (top_manifest.h) : the words changing on each frame (R/W indexes, collision
+        byte and node state) are moved to a separate table "S->arc_hot", the arc descriptors
+        in the graph are only read after reset. The table is initialized from RD_ARCW2/WR_ARCW3.
+
+    The hot record keeps the byte distance between the collision byte and the node state byte
+        (COLLISION2CTRL_BYTES / COLL2NEWPARAM_BYTES). With a cache and MULTIPROCESSING the
+        read index (consumer) and the write index (producer) are on different cache lines.
+
+      CTRL_HOTW0  NEW_PARAM (bit 24)  byte 3 = node state, at COLLISION2CTRL_BYTES from the collision byte
+      RD_HOTW1    COLLISION (byte 3) + READ index   same bit-fields as RD_ARCW2
+      WR_HOTW2    ALIGNBLCK + WRITE index           same bit-fields as WR_ARCW3
+*/
+#define          CTRL_HOTW0    U(0)
+#define            RD_HOTW1    U(1)
+#if CACHE_LINE_BYTE_LENGTH == 0
+#define            WR_HOTW2    U(2)
+#define SIZEOF_ARCHOT_W32      U(3)                         /* 12 bytes per arc */
+#else
+#ifdef MULTIPROCESSING
+#define            WR_HOTW2    U(CACHE_LINE_BYTE_LENGTH/4)  /* WRITE index on the next cache line */
+#define SIZEOF_ARCHOT_W32      U((2*CACHE_LINE_BYTE_LENGTH)/4)
+#else
+#define            WR_HOTW2    U(2)
+#define SIZEOF_ARCHOT_W32      U(CACHE_LINE_BYTE_LENGTH/4)   /* one cache line per arc */
+#endif
+#endif
+
+/* 
+    The arcs are addressed by their index in the graph (arcID of the nodes, IOARCID_IOFMT0 of the IOs),
+    the per-arc tables of the platform are indexed with it, the descriptor is at a constant stride.
+*/
+#define ARC_DESC(S,iarc) (&((S)->all_arcs[SIZEOF_ARCDESC_W32 * (iarc)]))
+
+/* linear base address of the buffer, pack2lin(BASE_ARCW0) done at reset and after IO_COMMAND_SET_BUFFER */
+#define ARC_BASE(S,iarc) ((uint8_t *)((S)->arc_base[iarc]))
+
+#ifdef ARC_HOT_COLD_SPLIT
+#define ARC_HOT_W32(S,iarc) (&((S)->arc_hot[SIZEOF_ARCHOT_W32 * (iarc)]))
+#define ARC_RD_W32(S,iarc) (ARC_HOT_W32(S,iarc)[RD_HOTW1])
+#define ARC_WR_W32(S,iarc) (ARC_HOT_W32(S,iarc)[WR_HOTW2])
+#else
+#define ARC_RD_W32(S,iarc) (ARC_DESC(S,iarc)[RD_ARCW2])
+#define ARC_WR_W32(S,iarc) (ARC_DESC(S,iarc)[WR_ARCW3])
+#endif
+
+/*
+    Arc index protocol : single producer (writes data, then WR_ARCW3) and single consumer (reads data, 
+        then RD_ARCW2), the producer can be NanoGraph_io_ack() called from an ISR or a DMA callback.
+
+    - the index of the other side is read with an acquire load before the data is accessed
+    - an index is published with a release store after the data moves, with a single store of the
+        word (the write index and ALIGNBLCK are updated together)
+    - the producer stops writing when ALIGNBLCK is set, the consumer then owns both indexes until
+        the realignment of data to the base address clears ALIGNBLCK
+*/
+#if defined(ARC_ACQUIRE_BARRIER)
+static inline uint32_t arc_load_acquire (volatile uint32_t *w) { uint32_t x = *w; ARC_ACQUIRE_BARRIER; return x; }
+static inline void arc_store_release (volatile uint32_t *w, uint32_t x) { ARC_RELEASE_BARRIER; *w = x; }
+#define ARC_LOAD_ACQUIRE(w)     arc_load_acquire(&(w))
+#define ARC_STORE_RELEASE(w,x)  arc_store_release(&(w), (x))
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define ARC_LOAD_ACQUIRE(w)     atomic_load_explicit((volatile _Atomic uint32_t *)&(w), memory_order_acquire)
+#define ARC_STORE_RELEASE(w,x)  atomic_store_explicit((volatile _Atomic uint32_t *)&(w), (x), memory_order_release)
+#else
+#define ARC_LOAD_ACQUIRE(w)     (*(volatile uint32_t *)&(w))
+#define ARC_STORE_RELEASE(w,x)  { DATA_MEMORY_BARRIER; *(volatile uint32_t *)&(w) = (x); }
+#endif
+
+#define ARC_RD_LOAD(S,iarc)     ARC_LOAD_ACQUIRE(ARC_RD_W32(S,iarc))
+#define ARC_WR_LOAD(S,iarc)     ARC_LOAD_ACQUIRE(ARC_WR_W32(S,iarc))
+#define ARC_RD_STORE(S,iarc,x)  ARC_STORE_RELEASE(ARC_RD_W32(S,iarc), (x))
+#define ARC_WR_STORE(S,iarc,x)  ARC_STORE_RELEASE(ARC_WR_W32(S,iarc), (x))
+
+/*
+    Extended arcs (ARC_EXTENDED and EXTDESC_ARCW3) for buffers above the 24-bit fields (2D frames) :
+        the byte-accurate sizes and indexes are in the table "S->arc_extended" indexed like the 
+        other per-arc tables, the arc indexes of the graph are not changed. The buffer size is 
+        given by the graph in BUFF_SIZE_ARCW1 with the format SIZE_EXT_FMT0 (SIZE_FMT0 << 2 x 
+        EXTENSION_FMT0) and expanded at reset. The flags (ALIGNBLCK, collision) stay in 
+        RD_ARCW2/WR_ARCW3, the flag EXTDESC_ARCW3 is static and read from the descriptor, the 
+        indexes are published with the same acquire/release protocol, the extended index is 
+        stored before the flag word.
+*/
+#define    XSIZE_ARCXW0    U(0)     /* 32-bit buffer size */
+#define    XREAD_ARCXW1    U(1)     /* 32-bit read index */
+#define   XWRITE_ARCXW2    U(2)     /* 32-bit write index */
+#define SIZEOF_ARCEXT_W32  U(3)
+
+#ifdef ARC_EXTENDED
+#define ARC_IS_EXT(S,iarc)      TEST_BIT(ARC_DESC(S,iarc)[WR_ARCW3], EXTDESC_ARCW3_LSB)
+#else
+#define ARC_IS_EXT(S,iarc)      0
+#endif
+#define ARC_XW32(S,iarc,w)      ((S)->arc_extended[SIZEOF_ARCEXT_W32 * (iarc) + (w)])
+
+/* buffer size and indexes of the arcs, the wr_w32 version extracts the index from a loaded WR word */
+#define ARC_SIZE(S,iarc)        (ARC_IS_EXT(S,iarc) ? ARC_XW32(S,iarc,XSIZE_ARCXW0) : RD(ARC_DESC(S,iarc)[SIZE_ARCW1], BUFF_SIZE_ARCW1))
+#define ARC_ST_SIZE(S,iarc,x)   { if (ARC_IS_EXT(S,iarc)) { ARC_XW32(S,iarc,XSIZE_ARCXW0) = U(x); } else { ST(ARC_DESC(S,iarc)[SIZE_ARCW1], BUFF_SIZE_ARCW1, (x)); } }
+#define ARC_READ(S,iarc)        (ARC_IS_EXT(S,iarc) ? ARC_LOAD_ACQUIRE(ARC_XW32(S,iarc,XREAD_ARCXW1)) : RD(ARC_RD_LOAD(S,iarc), READ_ARCW2))
+#define ARC_WRITE(S,iarc)       (ARC_IS_EXT(S,iarc) ? ARC_LOAD_ACQUIRE(ARC_XW32(S,iarc,XWRITE_ARCXW2)) : RD(ARC_WR_LOAD(S,iarc), WRITE_ARCW3))
+#define ARC_WRITE_W32(S,iarc,wr_w32) (ARC_IS_EXT(S,iarc) ? ARC_LOAD_ACQUIRE(ARC_XW32(S,iarc,XWRITE_ARCXW2)) : RD((wr_w32), WRITE_ARCW3))
+
+/* update the write index in the WR word to publish with ARC_WR_STORE (or in the extended table) */
+#define ARC_ST_WRITE(S,iarc,wr_w32,x) { if (ARC_IS_EXT(S,iarc)) { ARC_STORE_RELEASE(ARC_XW32(S,iarc,XWRITE_ARCXW2), U(x)); } else { ST((wr_w32), WRITE_ARCW3, (x)); } }
+
+/*
+    update the read index : the extended index is stored alone in its word, the RD word is not 
+        touched. The 24-bit index shares the RD word with the collision byte of the node locks, 
+        it is updated with a compare-and-swap of the word (ARC_RD_CAS) : a lock byte stored at 
+        the same time by another processor is kept. ARC_RD_CAS(w,old,new) stores "new" when 
+        "w" is still "old" and returns 1, else it loads "w" in "old" and returns 0 (platforms 
+        without C11 atomics give it in top_manifest.h). Without it the word is rewritten, the 
+        lock byte must then be written by the same processor.
+*/
+#if !defined(ARC_RD_CAS) && defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define ARC_RD_CAS(w,old,new) atomic_compare_exchange_weak_explicit((volatile _Atomic uint32_t *)&(w), &(old), (new), \
+    memory_order_release, memory_order_acquire)
+#endif
+
+#ifdef ARC_RD_CAS
+#define ARC_RD_INDEX_STORE(S,iarc,x) { uint32_t rd_x = U(x), rd_old = ARC_RD_LOAD(S,iarc), rd_new; \
+    do { rd_new = rd_old; ST(rd_new, READ_ARCW2, rd_x); } while (0 == ARC_RD_CAS(ARC_RD_W32(S,iarc), rd_old, rd_new)); }
+#else
+#define ARC_RD_INDEX_STORE(S,iarc,x) { uint32_t rd_w32 = ARC_RD_LOAD(S,iarc); \
+    ST(rd_w32, READ_ARCW2, (x)); ARC_RD_STORE(S,iarc,rd_w32); }
+#endif
+
+#define ARC_ST_READ(S,iarc,x) { if (ARC_IS_EXT(S,iarc)) { ARC_STORE_RELEASE(ARC_XW32(S,iarc,XREAD_ARCXW1), U(x)); } \
+    else ARC_RD_INDEX_STORE(S,iarc,x) }
+
+
 
 /* ============================================================================================ */
 /*================================= NANOGRAPH_HWIO_CONTROL (FLASH) =============================== */
@@ -1024,11 +1299,26 @@
 
 #define MAX_GRAPH_IO_IDX (1 << (IOARCID_IOFMT0_MSB - IOARCID_IOFMT0_LSB + 1))
 #define MAX_IO_ONGOING_BYTES (MAX_GRAPH_IO_IDX/8) // asynchronous/slave IOs managed by this instance/processor
+#define MAX_IO_FLOW_BYTES (64/4)    /* IO_FLOW_xx state of the commander IOs, 2 bits per IO of the iomask */
 
 #define IO_SETTING_OFFSET 1         /* IO settings are starting on index [IOFMT1] */
 #define IOFMT1 1u                   /* domain-specific controls */
-#define     unused_IOFMT1_MSB 11u   
-#define     unused_IOFMT1_LSB  6u   /* 26  */
+#define    FLOW_WR_IOFMT1_MSB 31u   /*    overflow of the commander IO (NanoGraph_io_ack RX) : 0 the new frame is lost */
+#define    FLOW_WR_IOFMT1_LSB 31u   /* 1  1 FLOW_WR_CROSSFADE the next frame is faded-in from the last sample of the arc */
+#define    FLOW_RD_IOFMT1_MSB 30u   /*    underflow of the commander IO (NanoGraph_io_ack TX) : 0 no data is sent */
+#define    FLOW_RD_IOFMT1_LSB 29u   /* 2  1 the last frame is repeated with a fade-out, 2 a null frame is sent */
+#define   COALESCE_IOFMT1_MSB 28u   /*    RX staging of the small acknowledges in the arc (IO_COALESCING) */
+#define   COALESCE_IOFMT1_LSB 19u   /* 10 timeout in [ms], 0 = the data is published on each acknowledge */
+#define    IOBSWAP_IOFMT1_MSB 18u   
+#define    IOBSWAP_IOFMT1_LSB 18u   /* 1  the IO samples are big-endian (IO_FORMAT_CONVERSION) */
+#define      IORAW_IOFMT1_MSB 17u   /*    raw format of the IO samples converted in the data copy (IO_FORMAT_CONVERSION) */
+#define      IORAW_IOFMT1_LSB 12u   /* 6  0 = same as the arc, NANOGRAPH_S16/S23/S23_32/S32/FP32 */
+#define    unused1_IOFMT1_MSB 11u   
+#define    unused1_IOFMT1_LSB  8u   /* 4  */
+#define  DRIFTCOMP_IOFMT1_MSB  7u   /*    clock drift compensation of the IO (IO_DRIFT_COMPENSATION) */
+#define  DRIFTCOMP_IOFMT1_LSB  7u   /* 1  the IO data is resampled to keep its arc half full */
+#define   BACKPRES_IOFMT1_MSB  6u   /*    the commander IO receives NANOGRAPH_FLOW_CONTROL (pause/slow-down/resume) */
+#define   BACKPRES_IOFMT1_LSB  6u   /* 1  from the occupancy of its RX arc, sent by the scheduler */
 #define SAMPLINGRT_IOFMT1_MSB  5u 
 #define SAMPLINGRT_IOFMT1_LSB  0u   /* 6  sampling rate selection from the manifest options */
 
@@ -37,6 +37,20 @@ extern void nanograph_interpreter (uint32_t command,  nanograph_instance_t *S, u
 
 /* entry point from the device drivers */
 extern void nanograph_io_ack (uint8_t io_al_idx, void *data, uintptr_t size);
+extern void NanoGraph_io_ack_post (uint8_t graph_hwio_idx, void *data, uintptr_t size);
+extern void NanoGraph_io_ackv (uint8_t graph_hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments);
+#ifdef IO_ACK_QUEUE
+extern void io_ack_drain (nanograph_instance_t *S);
+#endif
+#ifdef IO_COALESCING
+extern void io_coalesce_timeout (nanograph_instance_t *S, uint32_t graph_io_idx, uint32_t iarc);
+#endif
+
+/* log of the IO events (IO_RECORD) */
+extern void platform_io_record (uint8_t kind, uint8_t hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments);
+
+/* back-pressure to the commander IOs (BACKPRES_IOFMT1) */
+extern void io_flow_control_update (nanograph_instance_t *S, uint8_t graph_io_idx, uint32_t iarc, uint32_t occupancy);
 
 /* entry point from the computing nodes */
 extern void nanograph_services(uint32_t command, intptr_t ptr1, intptr_t ptr2, intptr_t ptr3, intptr_t n);
@@ -51,10 +65,21 @@ extern void platform_init_nanograph_instance(nanograph_instance_t* S);
 
 extern void pack2lin(uintptr_t* R, uint32_t x, uint8_t** LL);
 
+extern uint32_t lin2pack(intptr_t buffer, uint8_t** long_offset);
+
+/* arc occupancy watermarks and sizing (ARC_WATERMARKS) */
+extern void arc_watermark_update(nanograph_instance_t* S, uint32_t iarc, uint32_t occupancy, uint8_t nearfull);
+
+extern void arc_recommended_sizes(nanograph_instance_t* S, uint32_t* sizes, uint32_t narc);
+
 /* ---- REFERENCES --------------------------------------------*/
 
 extern int32_t nanograph_bitsize_of_raw(uint8_t raw);
 
+extern uint32_t nanograph_history_bytes(uint32_t *format);
+
+extern uint32_t arc_history_init(nanograph_instance_t* S, uint32_t narc, uint32_t nformat);
+
 extern void nanograph_interpreter_process (nanograph_instance_t *nanograph_instance, int8_t command, uintptr_t data);
 
 #ifdef __cplusplus
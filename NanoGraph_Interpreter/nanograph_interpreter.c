@@ -60,7 +60,10 @@ void nanograph_interpreter (uint32_t command,  nanograph_instance_t *S, uintptr_
 	    case NANOGRAPH_RESET: 
 	    {   platform_init_nanograph_instance (S);
             
-            nanograph_interpreter_process (S, NANOGRAPH_RESET, 0);
+            /* a graph rejected by the platform (error_log) is not reset and stays out of RUN */
+            if (0 == S->error_log)
+            {   nanograph_interpreter_process (S, NANOGRAPH_RESET, 0);
+            }
             break;
         }
 
@@ -104,6 +107,17 @@ void nanograph_interpreter (uint32_t command,  nanograph_instance_t *S, uintptr_
             break;
         }
 
+        /* recommended BUFF_SIZE of the arcs from the occupancy watermarks (ARC_WATERMARKS)
+            nano_graph_interpreter (NANOGRAPH_ARC_SIZING, &instance, (uintptr_t)uint32_t sizes[narc], narc);
+         */
+#ifdef ARC_WATERMARKS
+        case NANOGRAPH_ARC_SIZING:
+        {
+            arc_recommended_sizes(S, (uint32_t *)ptr1, (uint32_t)ptr2);
+            break;
+        }
+#endif
+
         /* usage: nano_graph_interpreter (NANOGRAPH_STOP, &instance, 0, 0); */
         case NANOGRAPH_STOP:
 	    {
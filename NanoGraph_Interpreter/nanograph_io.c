@@ -31,40 +31,828 @@
 
 #include "../nanograph_interpreter.h"      
 
-/*----------------------------------------------------------------------------
-    convert a physical address to a portable multiprocessor address (software MMU)
- *----------------------------------------------------------------------------*/
-static uint32_t lin2pack (intptr_t buffer, uint8_t ** long_offset)
+/**
+  @brief         fade of one frame, used for the flow error corrections
+  @param[in/out] dst        frame to fade
+  @param[in]     hold       0 : "dst" is faded-out to silence, else "dst" is faded-in from the 
+                            interleaved sample of all the channels at "hold"
+  @param[in]     nbytes     frame size in bytes
+  @param[in]     fmt1       word FMT1 of the stream format (raw type, interleaving, nb channels)
+  @return        none
+
+  @par           linear ramps of "nbytes / (sample size x nb channels)" steps, applied on each channel.
+                 The raw types different from S16/S32/FP32 are not faded : the frame is cleared
+                 (fade-out) or left unchanged (fade-in).
+ */
+static void arc_flow_crossfade (uint8_t *dst, const uint8_t *hold, uint32_t nbytes, uint32_t fmt1)
+{
+    uint32_t nchan, nsamp, nbits, i, pos, ch;
+    int32_t up, down, gain;
+    uint8_t interleaved;
+
+    nchan = RD(fmt1, NCHANM1_FMT1) + 1;
+    interleaved = (uint8_t)(FMT_INTERLEAVED == RD(fmt1, INTERLEAV_FMT1));
+
+    switch (RD(fmt1, RAW_FMT1))
+    {
+    case NANOGRAPH_S16: nbits = 16; break;
+    case NANOGRAPH_S32: nbits = 32; break;
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+    case NANOGRAPH_FP32: nbits = 32; break;
+#endif
+    default: 
+        if (hold == 0) 
+        {   MEMSET(dst, 0, nbytes)
+        }
+        return;
+    }
+
+    nsamp = nbytes / ((nbits / 8) * nchan);     /* samples per channel */
+    if (nsamp == 0)
+    {   return;
+    }
+
+    for (i = 0; i < nsamp * nchan; i++)
+    {   pos = (interleaved) ? (i / nchan) : (i % nsamp);
+        ch = (interleaved) ? (i % nchan) : (i / nsamp);
+        up = (int32_t)((pos << 15) / nsamp);    /* Q15 gains */
+        down = (1 << 15) - up;
+        gain = (hold == 0) ? down : up;
+
+        switch (RD(fmt1, RAW_FMT1))
+        {
+        case NANOGRAPH_S16:
+        {   int16_t *d = (int16_t *)dst; const int16_t *h = (const int16_t *)hold;
+            d[i] = (int16_t)((d[i] * gain + ((h == 0) ? 0 : h[ch] * down)) >> 15);
+            break;
+        }
+        case NANOGRAPH_S32:
+        {   int32_t *d = (int32_t *)dst; const int32_t *h = (const int32_t *)hold;
+            d[i] = (int32_t)(((int64_t)d[i] * gain + ((h == 0) ? 0 : (int64_t)h[ch] * down)) >> 15);
+            break;
+        }
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+        case NANOGRAPH_FP32:
+        {   float *d = (float *)dst; const float *h = (const float *)hold;
+            d[i] = (d[i] * (float)gain + ((h == 0) ? 0.0f : h[ch] * (float)down)) * (1.0f / 32768.0f);
+            break;
+        }
+#endif
+        default: 
+            break;
+        }
+    }
+}
+
+
+/**
+  @brief         fade-in of the first RX frame written after an overflow (FLOW_WR_CROSSFADE)
+  @param[in/out] base       base address of the arc
+  @param[in]     write      write index of the new frame, the data before it is published
+  @param[in]     nbytes     frame size in bytes
+  @param[in]     fmt1       word FMT1 of the producer format
+  @return        none
+
+  @par           The lost frame is replaced by a ramp from the last sample published in the arc 
+                 to the new frame, the published data is only read. The producer owns the 
+                 write index : the consumer does not realign the arc (ALIGNBLCK_ARCW3 is clear).
+                 Multichannel frames which are not interleaved are not faded.
+ */
+static void arc_flow_fade_in (uint8_t *base, uint32_t write, uint32_t nbytes, uint32_t fmt1)
+{
+    uint32_t nchan, group;
+
+    nchan = RD(fmt1, NCHANM1_FMT1) + 1;
+    if (nchan > 1 && FMT_INTERLEAVED != RD(fmt1, INTERLEAV_FMT1))
+    {   return;
+    }
+    group = nchan * (uint32_t)(nanograph_bitsize_of_raw((uint8_t)RD(fmt1, RAW_FMT1)) / 8);
+    if (group == 0 || write < group)
+    {   return;     /* nothing published before the new frame */
+    }
+    arc_flow_crossfade(&(base[write]), &(base[write - group]), nbytes, fmt1);
+}
+
+
+/**
+  @brief         saturated increment of a flow error counter
+  @param[in/out] counter    word OVERFLOW_FLOWCNT or UNDERFLOW_FLOWCNT of an arc
+  @return        none
+
+  @par           Each word has a single writer : the RX acknowledges of the producer IO write
+                 OVERFLOW_FLOWCNT, the TX acknowledges of the consumer IO write UNDERFLOW_FLOWCNT.
+ */
+static void arc_flow_count (uint32_t *counter)
+{
+    if (RD(*counter, COUNT_FLOWCNT) < (1u << (COUNT_FLOWCNT_MSB - COUNT_FLOWCNT_LSB + 1)) - 1u)
+    {   *counter += 1u << COUNT_FLOWCNT_LSB;
+    }
+}
+
+
+#ifdef ARC_TIMESTAMPS
+/**
+  @brief         time-stamp of a frame received on an arc
+  @param[in]     S            instance
+  @param[in]     iarc         index of the arc written by the IO
+  @param[in]     size         frame size in bytes
+  @return        none
+
+  @par           The frame starts at the stream position of the write index. The streams with 
+                 FRAME_COUNTER time-stamps receive the index of the frame instead of the time.
+                 The entry is written before the write index is published.
+ */
+static void arc_time_stamp_push (nanograph_instance_t *S, uint32_t iarc, uint32_t size)
+{
+    uint32_t *ring, npush, entry, type;
+
+    type = ARC_TSTP_TYPE(S, ARC_DESC(S, iarc));
+    if (NO_TIMESTAMP == type)
+    {   return;
+    }
+    ring = &(S->arc_time_stamps[SIZEOF_ARCTSTP_W32 * iarc]);
+    npush = ring[NPUSH_ARCTSTP];
+    entry = RING_ARCTSTP + 2u * (npush & (ARC_TSTP_RING - 1u));
+    ring[entry] = ring[WRPOS_ARCTSTP];
+    ring[entry + 1u] = (FRAME_COUNTER == type) ? npush : ARC_TIME_STAMP_NOW();
+    ring[WRPOS_ARCTSTP] = ring[WRPOS_ARCTSTP] + size;
+    ring[NPUSH_ARCTSTP] = npush + 1u;
+}
+#define ARC_TSTP_PUSH(S,iarc,size) arc_time_stamp_push((S),(iarc),(size))
+#else
+#define ARC_TSTP_PUSH(S,iarc,size)
+#endif
+
+
+#ifdef IO_COALESCING
+/**
+  @brief         decision to keep the RX data staged after the write index
+  @param[in]     S            instance
+  @param[in]     iarc         index of the arc written by the IO
+  @param[in]     staged       bytes after the published write index, including the new data
+  @param[in]     occupancy    amount of data in the arc, including the staged data
+  @param[in]     timeout      COALESCE_IOFMT1 [ms]
+  @param[in]     align        the end of the buffer is reached, ALIGNBLCK is set
+  @return        1 when the data stays staged
+
+  @par           The data is published when the consumer can run (one consumer frame in the arc),
+                 when the timeout of the first staged acknowledge is passed, or when the end of 
+                 the buffer is reached (ALIGNBLCK). The ongoing flag and the wake-up of the 
+                 scheduler wait for the publication. Called on each acknowledge copying data : 
+                 the staged count is cleared with each publication.
+ */
+static uint8_t arc_coalesce_hold (nanograph_instance_t *S, uint32_t iarc, uint32_t staged, uint32_t occupancy, uint32_t timeout, uint32_t align)
+{
+    uint32_t *staging, now, consumer_frame_size, i;
+
+    staging = &(S->arc_staging[SIZEOF_ARCSTG_W32 * iarc]);
+    i = NANOGRAPH_FORMAT_SIZE_W32 * RD(ARC_DESC(S, iarc)[FMT_ARCW4], CONSUMFMT_ARCW4);
+    consumer_frame_size = RD(S->all_formats[i], FRAMESIZE_FMT0);
+    now = ARC_TIME_STAMP_NOW();
+
+    if (staging[STAGED_ARCSTG] == 0)
+    {   staging[DEADLINE_ARCSTG] = now + COALESCE_Q20(timeout);
+    }
+    if (0 == align && occupancy < consumer_frame_size && (int32_t)(now - staging[DEADLINE_ARCSTG]) < 0)
+    {   staging[STAGED_ARCSTG] = staged;
+        return 1;
+    }
+    staging[STAGED_ARCSTG] = 0;
+    return 0;
+}
+
+
+/**
+  @brief         publication of the RX data staged in the arc of an IO when its timeout is passed
+  @param[in]     S              instance
+  @param[in]     graph_io_idx   index of the IO in the graph
+  @param[in]     iarc           index of the arc written by the IO
+  @return        none
+
+  @par           Called by the scheduler, the timeout of an IO without new acknowledge is 
+                 checked against global_nanograph_time64. The acknowledges are processed by the 
+                 scheduler (IO_ACK_QUEUE) : the write index and the staging state have a single 
+                 writer. Like in the acknowledge the ongoing flag is cleared when the arc holds 
+                 one consumer frame.
+ */
+void io_coalesce_timeout (nanograph_instance_t *S, uint32_t graph_io_idx, uint32_t iarc)
+{
+    uint32_t *staging, wr_w32, consumer_frame_size, i;
+    uintptr_t write;
+
+    if (0 == RD(S->pio_graph[graph_io_idx * NANOGRAPH_IOFMT_SIZE_W32 + IOFMT1], COALESCE_IOFMT1))
+    {   return;
+    }
+    staging = &(S->arc_staging[SIZEOF_ARCSTG_W32 * iarc]);
+    if (staging[STAGED_ARCSTG] == 0 || (int32_t)(ARC_TIME_STAMP_NOW() - staging[DEADLINE_ARCSTG]) < 0)
+    {   return;
+    }
+
+    wr_w32 = ARC_WR_LOAD(S, iarc);
+    write = ARC_WRITE_W32(S, iarc, wr_w32) + staging[STAGED_ARCSTG];
+    staging[STAGED_ARCSTG] = 0;
+
+    i = NANOGRAPH_FORMAT_SIZE_W32 * RD(ARC_DESC(S, iarc)[FMT_ARCW4], CONSUMFMT_ARCW4);
+    consumer_frame_size = RD(S->all_formats[i], FRAMESIZE_FMT0);
+    if (write - ARC_READ(S, iarc) >= consumer_frame_size)
+    {   S->ongoing_async_IO[graph_io_idx / 8] &= (uint8_t)~(1 << (graph_io_idx % 8));
+    }
+    ARC_ST_WRITE(S, iarc, wr_w32, write)
+    ARC_WR_STORE(S, iarc, wr_w32);
+}
+#endif
+
+
+#ifdef IO_FORMAT_CONVERSION
+/*
+    conversions between the raw format of the IO and the one of the arc (IORAW_IOFMT1), 
+    through blocks of Q31 samples : one load loop per source format, one store loop per 
+    destination format, the loops are simple enough for the compiler vectorizer
+*/
+#define IO_CONVERT_BLOCK 32
+#define IO_BSWAP16(x) ((uint16_t)(((x) >> 8) | ((x) << 8)))
+#define IO_BSWAP32(x) (((x) >> 24) | (((x) >> 8) & 0xFF00u) | (((x) << 8) & 0xFF0000u) | ((x) << 24))
+
+/**
+  @brief         bytes of a sample of the formats converted by the IO acknowledge
+  @param[in]     raw        NANOGRAPH_S16 .. 
+  @return        bytes, 0 when the format is not converted
+ */
+static uint32_t io_convert_bytes (uint32_t raw)
+{
+    switch (raw)
+    {
+    case NANOGRAPH_S16: return 2;
+    case NANOGRAPH_S23: return 3;
+    case NANOGRAPH_S23_32: 
+    case NANOGRAPH_S32: return 4;
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+    case NANOGRAPH_FP32: return 4;
+#endif
+    default: return 0;
+    }
+}
+
+/* rounding of a right shift with saturation to the positive maximum */
+static int32_t io_convert_round (int32_t x, uint32_t shift)
+{   int32_t r = ((x >> (shift - 1)) + 1) >> 1;
+    return MIN(r, (int32_t)((1u << (31 - shift)) - 1u));
+}
+
+static void io_convert_load (int32_t *q31, const uint8_t *src, uint32_t raw, uint32_t n, uint8_t bswap)
+{   uint32_t i;
+
+    switch (raw)
+    {
+    case NANOGRAPH_S16:
+    {   const uint16_t *s = (const uint16_t *)src;
+        for (i = 0; i < n; i++)
+        {   uint16_t x = bswap ? IO_BSWAP16(s[i]) : s[i];
+            q31[i] = (int32_t)((uint32_t)x << 16);
+        }
+        break;
+    }
+    case NANOGRAPH_S23:
+        for (i = 0; i < n; i++, src += 3)
+        {   uint32_t x = bswap ? ((uint32_t)src[0] << 16) | ((uint32_t)src[1] << 8) | src[2] :
+                                 ((uint32_t)src[2] << 16) | ((uint32_t)src[1] << 8) | src[0];
+            q31[i] = (int32_t)(x << 8);
+        }
+        break;
+    case NANOGRAPH_S23_32:
+    case NANOGRAPH_S32:
+    {   const uint32_t *s = (const uint32_t *)src;
+        uint32_t shift = (raw == NANOGRAPH_S23_32) ? 8 : 0;
+        for (i = 0; i < n; i++)
+        {   uint32_t x = bswap ? IO_BSWAP32(s[i]) : s[i];
+            q31[i] = (int32_t)(x << shift);
+        }
+        break;
+    }
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+    case NANOGRAPH_FP32:
+    {   const uint32_t *s = (const uint32_t *)src;
+        conv_int32_fp32_t x;
+        for (i = 0; i < n; i++)
+        {   x.u = bswap ? IO_BSWAP32(s[i]) : s[i];
+            q31[i] = (x.f >= 1.0f) ? 0x7FFFFFFF : (x.f <= -1.0f) ? (int32_t)0x80000000u : 
+                     (x.f != x.f) ? 0 : (int32_t)(x.f * 2147483648.0f);     /* NaN is silence */
+        }
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+}
+
+static void io_convert_store (uint8_t *dst, const int32_t *q31, uint32_t raw, uint32_t n, uint8_t bswap)
+{   uint32_t i;
+
+    switch (raw)
+    {
+    case NANOGRAPH_S16:
+    {   uint16_t *d = (uint16_t *)dst;
+        for (i = 0; i < n; i++)
+        {   uint16_t x = (uint16_t)io_convert_round(q31[i], 16);
+            d[i] = bswap ? IO_BSWAP16(x) : x;
+        }
+        break;
+    }
+    case NANOGRAPH_S23:
+        for (i = 0; i < n; i++, dst += 3)
+        {   uint32_t x = (uint32_t)io_convert_round(q31[i], 8);
+            dst[bswap ? 2 : 0] = (uint8_t)x;
+            dst[1] = (uint8_t)(x >> 8);
+            dst[bswap ? 0 : 2] = (uint8_t)(x >> 16);
+        }
+        break;
+    case NANOGRAPH_S23_32:
+    case NANOGRAPH_S32:
+    {   uint32_t *d = (uint32_t *)dst;
+        for (i = 0; i < n; i++)
+        {   uint32_t x = (uint32_t)((raw == NANOGRAPH_S23_32) ? io_convert_round(q31[i], 8) : q31[i]);
+            d[i] = bswap ? IO_BSWAP32(x) : x;
+        }
+        break;
+    }
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+    case NANOGRAPH_FP32:
+    {   uint32_t *d = (uint32_t *)dst;
+        conv_int32_fp32_t x;
+        for (i = 0; i < n; i++)
+        {   x.f = (float)q31[i] * (1.0f / 2147483648.0f);
+            d[i] = bswap ? IO_BSWAP32(x.u) : x.u;
+        }
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+}
+
+/**
+  @brief         conversion of samples between the IO and the arc
+  @param[out]    dst        destination samples
+  @param[in]     dst_raw    format of the destination
+  @param[in]     dst_swap   the destination is big-endian
+  @param[in]     src        source samples
+  @param[in]     src_raw    format of the source
+  @param[in]     src_swap   the source is big-endian
+  @param[in]     nsamples   number of samples
+  @return        none
+
+  @par           A byte swap without format change of FP32 samples is made on their bit 
+                 pattern. The float conversions saturate at [-1 .. 1[, NaN is converted to 0.
+ */
+static void io_convert (uint8_t *dst, uint32_t dst_raw, uint8_t dst_swap, const uint8_t *src, uint32_t src_raw, uint8_t src_swap, uint32_t nsamples)
+{   int32_t q31[IO_CONVERT_BLOCK];
+    uint32_t n;
+
+    if (src_raw == dst_raw && src_raw == NANOGRAPH_FP32)
+    {   src_raw = dst_raw = NANOGRAPH_S32;
+    }
+    while (nsamples > 0)
+    {   n = MIN(nsamples, IO_CONVERT_BLOCK);
+        io_convert_load(q31, src, src_raw, n, src_swap);
+        io_convert_store(dst, q31, dst_raw, n, dst_swap);
+        src = src + n * io_convert_bytes(src_raw);
+        dst = dst + n * io_convert_bytes(dst_raw);
+        nsamples = nsamples - n;
+    }
+}
+
+/**
+  @brief         conversion of the IO segments to/from the arc data
+  @param[in/out] arc_data   arc data, destination of RX and source of TX
+  @param[in]     segment    segments of the IO frame
+  @param[in]     nb_segments number of segments
+  @param[in]     arc_raw    format of the arc
+  @param[in]     io_raw     format of the IO
+  @param[in]     io_swap    the IO samples are big-endian
+  @param[in]     tx         0 : IO to arc (RX), 1 : arc to IO (TX)
+  @return        bytes of arc data
+
+  @par           The samples are counted on the whole frame : a sample split between two 
+                 segments (a DMA ring wrapping in the middle of a 24-bit sample) is carried 
+                 to the next segment. The arc data is (total IO bytes / IO sample) samples.
+ */
+static uint32_t io_convert_segments (uint8_t *arc_data, const nanograph_io_segment_t *segment, uint32_t nb_segments, 
+                    uint32_t arc_raw, uint32_t io_raw, uint8_t io_swap, uint8_t tx)
+{   uint8_t carry[4], *io;
+    uint32_t iseg, io_bytes, arc_bytes, ncarry, nsamples, budget, n, pos, rem;
+
+    io_bytes = io_convert_bytes(io_raw);
+    arc_bytes = io_convert_bytes(arc_raw);
+    for (budget = 0, iseg = 0; iseg < nb_segments; iseg++)
+    {   budget = budget + (uint32_t)(segment[iseg].size);
+    }
+    budget = budget / io_bytes;
+
+    for (nsamples = ncarry = 0, iseg = 0; iseg < nb_segments; iseg++)
+    {   io = (uint8_t *)(segment[iseg].data);
+        pos = 0;
+
+        /* end of the sample started in the previous segment */
+        if (ncarry != 0)
+        {   n = MIN(io_bytes - ncarry, (uint32_t)(segment[iseg].size));
+            if (tx)
+            {   MEMCPY(io, &(carry[ncarry]), n)
+            }
+            else
+            {   MEMCPY(&(carry[ncarry]), io, n)
+            }
+            ncarry = ncarry + n;
+            pos = n;
+            if (ncarry < io_bytes)
+            {   continue;
+            }
+            if (0 == tx)
+            {   io_convert(&(arc_data[(nsamples - 1) * arc_bytes]), arc_raw, 0, carry, io_raw, io_swap, 1);
+            }
+            ncarry = 0;
+        }
+
+        /* whole samples of the segment */
+        n = (uint32_t)(segment[iseg].size - pos) / io_bytes;
+        if (tx)
+        {   io_convert(&(io[pos]), io_raw, io_swap, &(arc_data[nsamples * arc_bytes]), arc_raw, 0, n);
+        }
+        else
+        {   io_convert(&(arc_data[nsamples * arc_bytes]), arc_raw, 0, &(io[pos]), io_raw, io_swap, n);
+        }
+        nsamples = nsamples + n;
+        pos = pos + n * io_bytes;
+
+        /* start of a sample ending in the next segment */
+        rem = (uint32_t)(segment[iseg].size) - pos;
+        if (rem != 0 && nsamples < budget)
+        {   if (tx)
+            {   io_convert(carry, io_raw, io_swap, &(arc_data[nsamples * arc_bytes]), arc_raw, 0, 1);
+                MEMCPY(&(io[pos]), carry, rem)
+            }
+            else
+            {   MEMCPY(carry, &(io[pos]), rem)
+            }
+            nsamples = nsamples + 1;
+            ncarry = rem;
+        }
+    }
+    return nsamples * arc_bytes;
+}
+#endif
+
+
+/* one loop per channel, unit-stride on the plane, the compiler vectorizes it with 
+    strided loads/stores (VLD2/VLD4 for 2/4 channels on Helium) */
+#define IO_PLANAR_LOOP(T)                                                       \
+    for (ichan = 0; ichan < nchan; ichan++)                                     \
+    {   T *p = (T *)(base + ichan * stride + index / nchan);                    \
+        T *f = (T *)frame + ichan;                                              \
+        if (tx)                                                                 \
+        {   for (i = 0; i < nsamples; i++) { f[i * nchan] = p[i]; }             \
+        }                                                                       \
+        else                                                                    \
+        {   for (i = 0; i < nsamples; i++) { p[i] = f[i * nchan]; }             \
+        }                                                                       \
+    }
+
+/**
+  @brief         bytes of a sample of one channel of a planar arc
+  @param[in]     S          instance
+  @param[in]     iarc       index of the arc
+  @return        bytes, at least 1
+ */
+static uint32_t io_planar_sample_bytes (nanograph_instance_t *S, uint32_t iarc)
 {
-    intptr_t distance;
-    uint32_t ret;
-    uint8_t i;
+    uint32_t i, sample_bytes;
+
+    i = NANOGRAPH_FORMAT_SIZE_W32 * RD(ARC_DESC(S, iarc)[FMT_ARCW4], CONSUMFMT_ARCW4);
+    sample_bytes = (uint32_t)nanograph_bitsize_of_raw((uint8_t)RD(S->all_formats[i + NCHANDOMAIN_FMT1], RAW_FMT1)) / 8;
+    return MAX(1u, sample_bytes);
+}
 
-    /* packed address range is [ long_offset[IDX]  +/- 8MB ]*/
-#define MAX_PACK_ADDR_RANGE (((1<<(SIZE_FMT0_MSB - SIZE_FMT0_LSB+1))-1))
+/**
+  @brief         the segments of a frame for a planar arc hold whole samples of all the channels
+  @param[in]     S            instance
+  @param[in]     iarc         index of the arc
+  @param[in]     segment      buffers of the frame
+  @param[in]     nb_segments  number of segments
+  @return        1 when each segment can be (de)interleaved alone
+
+  @par           The samples are not carried between the segments of a planar IO : a segment 
+                 ending in the middle of a sample would shift the channels of the next one, the 
+                 frame is rejected (overflow in RX, underflow in TX).
+ */
+static uint8_t io_planar_whole_samples (nanograph_instance_t *S, uint32_t iarc, const nanograph_io_segment_t *segment, uint32_t nb_segments)
+{
+    uint32_t iseg, group;
+
+    group = ARC_NCHAN(S, ARC_DESC(S, iarc)) * io_planar_sample_bytes(S, iarc);
+    for (iseg = 0; iseg < nb_segments; iseg++)
+    {   if (0 != (segment[iseg].size % group))
+        {   return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+  @brief         data copy between an interleaved IO frame and the planes of an arc
+  @param[in]     S          instance
+  @param[in]     iarc       index of the arc (PLANAR_ARCW4 = 1)
+  @param[in]     index      write index (RX) or read index (TX) of the arc
+  @param[in/out] frame      interleaved samples of the IO
+  @param[in]     nbytes     bytes of the frame, all the channels
+  @param[in]     tx         0 : the frame is deinterleaved to the planes, 1 : the planes are interleaved to the frame
+  @return        none
+
+  @par           The multichannel IO bursts are deinterleaved once in the acknowledge, the 
+                 nodes consuming the planar arc use unit-stride accesses. The frame holds a 
+                 whole number of samples of all the channels (io_planar_whole_samples).
+ */
+static void io_planar_copy (nanograph_instance_t *S, uint32_t iarc, uintptr_t index, uint8_t *frame, uint32_t nbytes, uint8_t tx)
+{
+    uint32_t nchan, stride, sample_bytes, nsamples, ichan, i, ibyte, *arc;
+    uint8_t *base;
+
+    arc = ARC_DESC(S, iarc);
+    base = ARC_BASE(S, iarc);
+    nchan = ARC_NCHAN(S, arc);
+    stride = ARC_SIZE(S, iarc) / nchan;
+    sample_bytes = io_planar_sample_bytes(S, iarc);
+    nsamples = nbytes / (nchan * sample_bytes);
+
+    switch (sample_bytes)
+    {
+    case 1: IO_PLANAR_LOOP(uint8_t)  break;
+    case 2: IO_PLANAR_LOOP(uint16_t) break;
+    case 4: IO_PLANAR_LOOP(uint32_t) break;
+    case 8: IO_PLANAR_LOOP(uint64_t) break;
+    default:    /* S23 and wide samples */
+        for (ichan = 0; ichan < nchan; ichan++)
+        {   uint8_t *p = base + ichan * stride + index / nchan;
+            uint8_t *f = frame + ichan * sample_bytes;
+            for (i = 0; i < nsamples; i++, p += sample_bytes, f += nchan * sample_bytes)
+            {   for (ibyte = 0; ibyte < sample_bytes; ibyte++)
+                {   if (tx) { f[ibyte] = p[ibyte]; } else { p[ibyte] = f[ibyte]; }
+                }
+            }
+        }
+        break;
+    }
+}
+
+
+#ifdef IO_DRIFT_COMPENSATION
+/**
+  @brief         bytes of one sample of all the channels, 0 when the format is not resampled
+  @param[in]     fmt1       word FMT1 of the stream format
+  @return        bytes
+ */
+static uint32_t arc_drift_frame_bytes (uint32_t fmt1)
+{
+    uint32_t nchan = RD(fmt1, NCHANM1_FMT1) + 1;
 
-    /* find the base offset */
-    for (distance = i = 0; i < (uint8_t)MAX_PROC_MEMBANK; i++)
+    if (nchan > DRIFT_MAX_CHANNELS || FMT_INTERLEAVED != RD(fmt1, INTERLEAV_FMT1))
+    {   return 0;
+    }
+    switch (RD(fmt1, RAW_FMT1))
     {
-        distance = buffer - (intptr_t)(long_offset[i]);
-        if (ABS(distance) < MAX_PACK_ADDR_RANGE) 
+    case NANOGRAPH_S16: return 2 * nchan;
+    case NANOGRAPH_S32: return 4 * nchan;
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+    case NANOGRAPH_FP32: return 4 * nchan;
+#endif
+    default: return 0;
+    }
+}
+
+
+/**
+  @brief         drift estimation from the occupancy of the arc
+  @param[in/out] drift      state of the arc, SIZEOF_ARCDRIFT_W32 words
+  @param[in]     occupancy  amount of data in the arc before the data move
+  @param[in]     fifosize   size of the arc
+  @return        none
+
+  @par           PI controller of the resampling step, the error is the distance to the half 
+                 of the buffer. A step above 1.0 consumes more input samples : the arc is emptied 
+                 faster on TX, filled slower on RX.
+ */
+static void arc_drift_estimate (uint32_t *drift, uint32_t occupancy, uint32_t fifosize)
+{
+    int32_t error, fill, integ, step;
+
+    error = (int32_t)((((int64_t)occupancy - (int64_t)(fifosize / 2)) << 16) / (int64_t)fifosize);
+    fill = (int32_t)drift[FILL_DRIFT];
+    fill = fill + ((error - fill) >> DRIFT_LPF_SHIFT);
+
+    integ = (int32_t)drift[INTEG_DRIFT] + (fill >> DRIFT_KI_SHIFT);
+    integ = MAX(-DRIFT_MAX_STEP, MIN(DRIFT_MAX_STEP, integ));
+
+    step = (fill << DRIFT_KP_SHIFT) + integ;
+    step = MAX(-DRIFT_MAX_STEP, MIN(DRIFT_MAX_STEP, step));
+
+    drift[FILL_DRIFT] = (uint32_t)fill;
+    drift[INTEG_DRIFT] = (uint32_t)integ;
+    drift[STEP_DRIFT] = DRIFT_UNITY + (uint32_t)step;
+}
+
+
+/**
+  @brief         asynchronous resampler, linear interpolation of interleaved samples
+  @param[in/out] drift      state of the arc : phase, step and last input sample of each channel
+  @param[in]     src        input samples
+  @param[in]     nsrc       bytes of input
+  @param[out]    dst        output samples
+  @param[in]     ndst       bytes of output
+  @param[in]     fmt1       word FMT1 of the stream format
+  @param[out]    consumed   bytes of input used
+  @return        bytes produced
+
+  @par           The output stops when "ndst" is reached or when the input is exhausted. The 
+                 position of the next output is the index of the input sample "i" and its Q28 
+                 fraction : the frames are not limited to 16 samples by the Q28 range. The 
+                 phase saved after the last input sample used is below 2.0, the interpolation 
+                 between two frames uses the history sample.
+ */
+static uint32_t arc_drift_resample (uint32_t *drift, uint8_t *src, uint32_t nsrc, uint8_t *dst, uint32_t ndst, uint32_t fmt1, uint32_t *consumed)
+{
+    uint32_t frame_bytes, nchan, nin, nout, iout, i, ichan, t, frac, used;
+
+    frame_bytes = arc_drift_frame_bytes(fmt1);
+    nchan = RD(fmt1, NCHANM1_FMT1) + 1;
+    nin = nsrc / frame_bytes;
+    nout = ndst / frame_bytes;
+    i = drift[PHASE_DRIFT] >> 28;
+    t = drift[PHASE_DRIFT] & (DRIFT_UNITY - 1u);
+
+    for (iout = 0; iout < nout; iout++)
+    {   if (i >= nin)
         {   break;
         }
+        frac = t >> 13;                 /* Q15 weight of the sample i */
+
+        for (ichan = 0; ichan < nchan; ichan++)
+        {   switch (RD(fmt1, RAW_FMT1))
+            {
+            case NANOGRAPH_S16:
+            {   int16_t *s = (int16_t *)src, *d = (int16_t *)dst;
+                int32_t a = (i == 0) ? (int16_t)drift[HIST_DRIFT + ichan] : s[(i - 1) * nchan + ichan];
+                int32_t b = s[i * nchan + ichan];
+                d[iout * nchan + ichan] = (int16_t)(a + (((b - a) * (int32_t)frac) >> 15));
+                break;
+            }
+            case NANOGRAPH_S32:
+            {   int32_t *s = (int32_t *)src, *d = (int32_t *)dst;
+                int64_t a = (i == 0) ? (int32_t)drift[HIST_DRIFT + ichan] : s[(i - 1) * nchan + ichan];
+                int64_t b = s[i * nchan + ichan];
+                d[iout * nchan + ichan] = (int32_t)(a + (((b - a) * (int64_t)frac) >> 15));
+                break;
+            }
+#ifdef NANOGRAPH_FLOAT_ALLOWED
+            case NANOGRAPH_FP32:
+            {   float *s = (float *)src, *d = (float *)dst, a;
+                conv_int32_fp32_t h;
+                h.u = drift[HIST_DRIFT + ichan];
+                a = (i == 0) ? h.f : s[(i - 1) * nchan + ichan];
+                d[iout * nchan + ichan] = a + (s[i * nchan + ichan] - a) * ((float)frac * (1.0f / 32768.0f));
+                break;
+            }
+#endif
+            default: 
+                break;
+            }
+        }
+        t = t + drift[STEP_DRIFT];
+        i = i + (t >> 28);
+        t = t & (DRIFT_UNITY - 1u);
+    }
+
+    /* the input samples passed by the phase are consumed, the last one is the next history */
+    used = MIN(i, nin);
+    if (used > 0)
+    {   for (ichan = 0; ichan < nchan; ichan++)
+        {   if (frame_bytes == 2 * nchan)
+            {   drift[HIST_DRIFT + ichan] = (uint32_t)(int32_t)(((int16_t *)src)[(used - 1) * nchan + ichan]);
+            }
+            else
+            {   drift[HIST_DRIFT + ichan] = ((uint32_t *)src)[(used - 1) * nchan + ichan];
+            }
+        }
+    }
+    drift[PHASE_DRIFT] = ((i - used) << 28) | t;
+    *consumed = used * frame_bytes;
+    return iout * frame_bytes;
+}
+#endif
+
+
+/**
+  @brief         instance in charge of an IO
+  @param[in]     graph_hwio_idx   index of the IO in the platform
+  @return        instance having the affinity with the IO, given in the HW IO descriptor
+ */
+static nanograph_instance_t *io_ack_instance (uint8_t graph_hwio_idx)
+{
+    extern uintptr_t all_ptr_instances[];
+    extern nanograph_instance_t* platform_io_callback_parameter;
+    uint32_t *pio_hw_control;
+    uint8_t instance_idx;
+
+    /* read the HW IO detail from the graph using the default instance pointer */
+    pio_hw_control = &(platform_io_callback_parameter->pio_hw[graph_hwio_idx * TRANSLATE_PLATFORM_HWIO_AL_IDX_SIZE_W32]);
+    instance_idx = (uint8_t)RD(*pio_hw_control, FWIOIDX_IOFMT0);
+    return (nanograph_instance_t*)all_ptr_instances[instance_idx];
+}
+
+
+#ifdef IO_ACK_QUEUE
+/**
+  @brief         is the IO in-place (IO_COMMAND_SET_BUFFER) ?
+  @param[in]     graph_hwio_idx   index of the IO in the platform
+  @return        1 when the acknowledge rebases the arc on the buffer of the IO
+
+  @par           The rebase sets both indexes of the arc : it is made by the scheduler, the 
+                 acknowledges of the in-place IOs are always posted (see NanoGraph_io_ack).
+ */
+static uint8_t io_ack_in_place (uint8_t graph_hwio_idx)
+{
+    extern nanograph_instance_t* platform_io_callback_parameter;
+    nanograph_instance_t *S = platform_io_callback_parameter;
+    uint32_t graph_io_idx;
+
+    graph_io_idx = RD(S->pio_hw[graph_hwio_idx * TRANSLATE_PLATFORM_HWIO_AL_IDX_SIZE_W32], IDX_TO_NANOGRAPH_HWIO_CONTROL);
+    return (uint8_t)(IO_COMMAND_SET_BUFFER == RD(S->pio_graph[graph_io_idx * NANOGRAPH_IOFMT_SIZE_W32], SET0COPY1_IOFMT0));
+}
+#endif
+
+
+/**
+  @brief         back-pressure to a commander IO
+  @param[in]     S            instance
+  @param[in]     graph_io_idx index of the IO in the graph
+  @param[in]     iarc         index of the arc written by the IO
+  @param[in]     occupancy    amount of data in the arc
+  @return        none
+
+  @par           The commander IOs with BACKPRES_IOFMT1 receive NANOGRAPH_FLOW_CONTROL with 
+                 IO_FLOW_SLOWDOWN when the arc is half full, IO_FLOW_PAUSE when 3/4 full and 
+                 IO_FLOW_RESUME when the occupancy is back below 1/4. The command is sent only 
+                 on state changes. Only the scheduler of the instance owning the IO calls this
+                 function : io_flow_state[] has a single writer and is not modified by the 
+                 acknowledges from the interrupts.
+ */
+void io_flow_control_update (nanograph_instance_t *S, uint8_t graph_io_idx, uint32_t iarc, uint32_t occupancy)
+{
+    uint32_t fifosize, *pio_control;
+    uint8_t old_state, new_state, shift;
+    nanograph_xdmbuffer_t pt_pt;
+    const p_io_function_ctrl *io_func;
+
+    pio_control = &(S->pio_graph[graph_io_idx * NANOGRAPH_IOFMT_SIZE_W32]);
+    if (0 == TEST_BIT(pio_control[IOFMT1], BACKPRES_IOFMT1_LSB) || graph_io_idx >= 4 * MAX_IO_FLOW_BYTES)
+    {   return;
+    }
+
+    fifosize = ARC_SIZE(S, iarc);
+    shift = (uint8_t)(2 * (graph_io_idx & 3));
+    old_state = (uint8_t)(3 & (S->io_flow_state[graph_io_idx / 4] >> shift));
+    new_state = old_state;
+
+    if (occupancy >= fifosize - fifosize / 4)
+    {   new_state = IO_FLOW_PAUSE;
+    }
+    else if (occupancy >= fifosize / 2)
+    {   if (old_state == IO_FLOW_RESUME)
+        {   new_state = IO_FLOW_SLOWDOWN;
+        }
+    }
+    else if (occupancy <= fifosize / 4)
+    {   new_state = IO_FLOW_RESUME;
+    }
+
+    if (new_state == old_state)
+    {   return;
     }
+    S->io_flow_state[graph_io_idx / 4] = (uint8_t)((S->io_flow_state[graph_io_idx / 4] & ~(3 << shift)) | (new_state << shift));
 
-    ret = 0;
-    ST(ret, DATAOFF_ARCW0, i);              // base index (software MMU)
-    ST(ret, SIGNED_SIZE_FMT0, distance);    // signed offset from this address
-    return ret;
+    io_func = &(S->platform_io[RD(*pio_control, FWIOIDX_IOFMT0)]);
+    if (*io_func != 0)
+    {   pt_pt.address = (intptr_t)new_state;
+        pt_pt.size = (intptr_t)occupancy;
+        (*io_func)(NANOGRAPH_FLOW_CONTROL, &pt_pt);
+    }
 }
 
 
 /**
-  @brief         data transfer acknowledge
-  @param[in]     command    operation to do
-  @param[in]     ptr1       1st data pointer 
-  @param[in/out] ptr2       2nd data pointer 
-  @param[in]     data3      3rd parameter integer
+  @brief         data transfer acknowledge of a frame made of segments
+  @param[in]     graph_hwio_idx   index of the IO in the platform
+  @param[in]     segment          buffers of the frame, in order
+  @param[in]     nb_segments      number of segments
   @return        none
 
   @par           NanoGraph_io do the data moves with arc descriptor update
@@ -91,50 +879,73 @@ static uint32_t lin2pack (intptr_t buffer, uint8_t ** long_offset)
         Upon TX ISR (*,n) : check overflow, flag-reset happened, then either
             set the arc base address to * parameter, n = frame size, src=dst, reset the flag
             or copy arc[r], n data, R=R+n, if arc(available data) < Frame TX then reset the flag
+
+                 The data copies gather/scatter the segments directly from/to the arc. The 
+                 in-place IOs (IO_COMMAND_SET_BUFFER) map a single segment, the frames of 
+                 several segments are rejected like the segments of planar IOs not holding 
+                 whole samples.
+                 The samples are converted in the copy when the raw format of the IO is 
+                 different (IO_FORMAT_CONVERSION, IORAW_IOFMT1).
+                 The interleaved frames of the IO are deinterleaved to planar arcs (RX) and 
+                 interleaved from them (TX).
   @remark
  */
 
-void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
+static void io_ack_segments (uint8_t graph_hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments)
 {
-    extern uintptr_t all_ptr_instances[];
     extern nanograph_instance_t* platform_io_callback_parameter;
  
     nanograph_instance_t* S = platform_io_callback_parameter;
 
-    uint32_t *arc;
+    uint32_t *arc, iarc;
     uint32_t* pio_hw_control;
     uint32_t* pio_sw_control;
     uint8_t *long_base;
-    uintptr_t addr;
+    uint32_t *flow_errors;
     uint8_t *src;
     uint8_t *dst;
+    void *data;
+    uint32_t iseg;
 
+    uintptr_t size;
     uintptr_t read;
     uintptr_t write;
     uintptr_t fifosize;
+    uintptr_t margin;       /* extra free space/data needed by the resampler (IO_DRIFT_COMPENSATION) */
+    uint32_t wr_w32;
     uint8_t graph_io_idx;
-    uint8_t instance_idx;
     uint8_t ongoing_mask, ongoing_idx;
     uint8_t cache_flush;
+    uint8_t same_layout;    /* the IO frame is one buffer with the layout of the arc data */
+    uint8_t planar;         /* the interleaved IO frames are copied to/from the planes of the arc */
+    uint8_t rejected;       /* the segments can't be mapped to the arc : lost frame (RX), null frame (TX) */
+#ifdef IO_DRIFT_COMPENSATION
+    uint32_t *drift, drift_fmt1 = 0;
+#endif
+#ifdef IO_FORMAT_CONVERSION
+    uint32_t io_raw, io_bytes, arc_raw = 0, arc_bytes;
+    uint8_t io_swap = 0;
+#endif
+
 
+    /* the first segment is the frame of the single-buffer acknowledges */
+    data = segment[0].data;
+    for (size = 0, iseg = 0; iseg < nb_segments; iseg++)
+    {   size = size + segment[iseg].size;
+    }
 
     /* read the HW IO detail from the graph using the default instance pointer S */
     pio_hw_control = &(S->pio_hw[graph_hwio_idx * TRANSLATE_PLATFORM_HWIO_AL_IDX_SIZE_W32]);
     graph_io_idx = (uint8_t)RD(*pio_hw_control, IDX_TO_NANOGRAPH_HWIO_CONTROL);         /* IO SW index */
     pio_sw_control = &(S->pio_graph[graph_io_idx * NANOGRAPH_IOFMT_SIZE_W32]);
 
-    /* instance affinity index is in the HW IO descriptor */
-    instance_idx = (uint8_t)RD(*pio_hw_control, FWIOIDX_IOFMT0);
-
-    /* read the SW IO detail from the graph using the default instance pointer S */
-
     /* read the table of all the instances to switch to the right context */
-    S = (nanograph_instance_t*)all_ptr_instances[instance_idx];
+    S = io_ack_instance(graph_hwio_idx);
 
-    arc = S->all_arcs;
-    arc = &(arc[(int)SIZEOF_ARCDESC_W32 * (int)RD(*pio_sw_control, IOARCID_IOFMT0)]);  /* FIFO/arc descriptor */
-    pack2lin(&addr, arc[BASE_ARCW0], S->long_offset); 
-    long_base = (uint8_t*)addr;                                                     /* FIFO base address of the buffer */
+    iarc = RD(*pio_sw_control, IOARCID_IOFMT0);
+    arc = ARC_DESC(S, iarc);                                                        /* FIFO/arc descriptor */
+    long_base = ARC_BASE(S, iarc);                                                  /* FIFO base address of the buffer */
+    flow_errors = &(S->arc_flow_errors[SIZEOF_FLOWCNT_W32 * iarc]);
     cache_flush = RD(arc[BASE_ARCW0], MPFLUSH_ARCW0);
 
     
@@ -143,11 +954,71 @@ void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
         // INVALIDATE_BUFFER_1LINE((arc[SIZE_ARCW1]));
     }
 
-    fifosize = RD(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1);                                /* FIFO size */
-    read = RD(arc[RD_ARCW2], READ_ARCW2);
-    write = RD(arc[WR_ARCW3], WRITE_ARCW3);
+    fifosize = ARC_SIZE(S, iarc);                                /* FIFO size */
+    read = ARC_READ(S, iarc);
+    wr_w32 = ARC_WR_LOAD(S, iarc);
+    write = ARC_WRITE_W32(S, iarc, wr_w32);
     ongoing_idx = graph_io_idx / 8;
     ongoing_mask = (uint8_t)~(1 << (graph_io_idx - ongoing_idx * 8));
+    margin = 0;
+    planar = (uint8_t)ARC_IS_PLANAR(arc);
+    same_layout = (nb_segments == 1) && (0 == planar);
+
+    /* an in-place IO maps one buffer, the segments of a planar IO hold whole samples */
+    rejected = 0;
+    if (IO_COMMAND_SET_BUFFER == RD(*pio_sw_control, SET0COPY1_IOFMT0))
+    {   rejected = (uint8_t)(nb_segments > 1 || data == 0);
+    }
+    else if (planar && nb_segments > 1)
+    {   rejected = (uint8_t)(0 == io_planar_whole_samples(S, iarc, segment, nb_segments));
+    }
+
+    #ifdef IO_DRIFT_COMPENSATION
+    /* resampled IO data copy : the output can exceed the input by one sample per 500, plus 
+        the interpolation sample */
+    drift = 0;
+    if (TEST_BIT(pio_sw_control[IOFMT1], DRIFTCOMP_IOFMT1_LSB) &&
+        IO_COMMAND_SET_BUFFER != RD(*pio_sw_control, SET0COPY1_IOFMT0))
+    {   uint32_t i, frame_bytes;
+        i = TEST_BIT(*pio_sw_control, RX0TX1_IOFMT0_LSB) ? 
+            RD(arc[FMT_ARCW4], CONSUMFMT_ARCW4) : RD(arc[FMT_ARCW4], PRODUCFMT_ARCW4);
+        drift_fmt1 = S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * i + NCHANDOMAIN_FMT1];
+        frame_bytes = arc_drift_frame_bytes(drift_fmt1);
+        if (frame_bytes != 0)
+        {   drift = &(S->arc_drift[SIZEOF_ARCDRIFT_W32 * iarc]);
+            margin = 2 * frame_bytes + size / 256;
+        }
+    }
+    #endif
+
+    #ifdef IO_FORMAT_CONVERSION
+    /* IO samples converted in the data copy : "size" becomes the amount of bytes in the arc, the 
+        converted IOs are not resampled */
+    io_raw = 0;
+    if (0 != RD(pio_sw_control[IOFMT1], IORAW_IOFMT1) && 0 == planar &&
+        IO_COMMAND_SET_BUFFER != RD(*pio_sw_control, SET0COPY1_IOFMT0))
+    {   uint32_t i;
+        i = TEST_BIT(*pio_sw_control, RX0TX1_IOFMT0_LSB) ? 
+            RD(arc[FMT_ARCW4], CONSUMFMT_ARCW4) : RD(arc[FMT_ARCW4], PRODUCFMT_ARCW4);
+        arc_raw = RD(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * i + NCHANDOMAIN_FMT1], RAW_FMT1);
+        arc_bytes = io_convert_bytes(arc_raw);
+        io_raw = RD(pio_sw_control[IOFMT1], IORAW_IOFMT1);
+        io_bytes = io_convert_bytes(io_raw);
+        io_swap = (uint8_t)TEST_BIT(pio_sw_control[IOFMT1], IOBSWAP_IOFMT1_LSB);
+
+        if (io_bytes == 0 || arc_bytes == 0 || (io_raw == arc_raw && 0 == io_swap))
+        {   io_raw = 0;
+        }
+        else
+        {   size = (size / io_bytes) * arc_bytes;   /* samples split between segments are carried */
+            same_layout = 0;
+            #ifdef IO_DRIFT_COMPENSATION
+            drift = 0;
+            margin = 0;
+            #endif
+        }
+    }
+    #endif
 
     /*  test RX/TX  */
     if (0 == TEST_BIT(*pio_sw_control, RX0TX1_IOFMT0_LSB))
@@ -157,7 +1028,9 @@ void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
 
         /* invalidate/reload the cache for buffers used with DMA and multiprocessing */
         if (cache_flush)
-        {   INVALIDATE_BUFFER_RANGE(data, size);    
+        {   for (iseg = 0; iseg < nb_segments; iseg++)
+            {   INVALIDATE_BUFFER_RANGE(segment[iseg].data, segment[iseg].size);    
+            }
         }
 
         if (IO_COMMAND_SET_BUFFER != RD(*pio_sw_control, SET0COPY1_IOFMT0))
@@ -165,73 +1038,146 @@ void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
             /* IO_COMMAND_DATA_COPY : reset the ONGOING flag when enough small 
                 sub-frames have been received
             */  
-            if (fifosize - write < size)   /* free area too small => overflow */
-            {   /* overflow issue */
-                //platform_al(PLATFORM_ERROR, 0,0,0);
-                /* TODO : implement the flow management desired for "flow_error" */
-                //flow_error = (uint8_t) RD(arc[RD_ARCW2], OVERFLRD_ARCW2);
+            #ifdef IO_COALESCING
+            uintptr_t published = write;
+            uint32_t coalesce = RD(pio_sw_control[IOFMT1], COALESCE_IOFMT1);
+            if (coalesce != 0)
+            {   write = write + S->arc_staging[SIZEOF_ARCSTG_W32 * iarc + STAGED_ARCSTG];
+            }
+            #endif
+
+            /* free area too small => overflow, or the consumer is realigning the data (ALIGNBLCK) */
+            if ((fifosize - write < size + margin) || TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB) || rejected)
+            {   /* overflow issue : the new frame is lost, the next frame is faded-in */
+                if (FLOW_WR_CROSSFADE == RD(pio_sw_control[IOFMT1], FLOW_WR_IOFMT1) && 0 == planar)
+                {   SET_BIT(flow_errors[OVERFLOW_FLOWCNT], XFADE_FLOWCNT_LSB);
+                }
+                arc_flow_count(&(flow_errors[OVERFLOW_FLOWCNT]));
+                ARC_WATERMARK(S, iarc, (uint32_t)(write - read), 1);
                 dst = 0;
                 size = 0; // fifosize - write;
+
+                #ifdef IO_COALESCING
+                /* the staged data can't be completed : it is published and the consumer realigns 
+                    the arc (ALIGNBLCK is never set with staged data, see arc_coalesce_hold) */
+                if (write != published)
+                {   S->arc_staging[SIZEOF_ARCSTG_W32 * iarc + STAGED_ARCSTG] = 0;
+                    SET_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
+                    dst = &(long_base[published]);
+                }
+                #endif
             }
             else
             {   uint32_t producer_frame_size, i;
 
-                /* only one node can read the write-index at a time : no collision is possible */
-                src = data;
+                /* only one node can read the write-index at a time : no collision is possible, 
+                    the segments are gathered in the arc */
+                #ifdef IO_DRIFT_COMPENSATION
+                if (drift != 0)
+                {   uint32_t consumed;
+                    arc_drift_estimate(drift, (uint32_t)(write - read), (uint32_t)fifosize);
+                    for (size = 0, iseg = 0; iseg < nb_segments; iseg++)
+                    {   /* output bounded by the input and its resampling margin, not by the free space */
+                        size += arc_drift_resample(drift, (uint8_t *)(segment[iseg].data), (uint32_t)(segment[iseg].size), 
+                            &(long_base[write + size]), (uint32_t)MIN(fifosize - write - size, segment[iseg].size + margin), drift_fmt1, &consumed);
+                    }
+                }
+                else
+                #endif
+                #ifdef IO_FORMAT_CONVERSION
+                if (io_raw != 0)
+                {   io_convert_segments(&(long_base[write]), segment, nb_segments, arc_raw, io_raw, io_swap, 0);
+                }
+                else
+                #endif
+                {   dst = &(long_base[write]);
+                    for (iseg = 0; iseg < nb_segments; iseg++)
+                    {   src = (uint8_t *)(segment[iseg].data);
+                        if (planar)
+                        {   io_planar_copy(S, iarc, (uintptr_t)(dst - long_base), src, (uint32_t)(segment[iseg].size), 0);
+                            dst = dst + segment[iseg].size;
+                            continue;
+                        }
+                        MEMCPY (dst, src, segment[iseg].size)
+                        dst = dst + segment[iseg].size;
+                    }
+                }
+                if (TEST_BIT(flow_errors[OVERFLOW_FLOWCNT], XFADE_FLOWCNT_LSB))
+                {   i = NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4], PRODUCFMT_ARCW4);
+                    arc_flow_fade_in(long_base, (uint32_t)write, (uint32_t)size, S->all_formats[i + NCHANDOMAIN_FMT1]);
+                    CLEAR_BIT(flow_errors[OVERFLOW_FLOWCNT], XFADE_FLOWCNT_LSB);
+                }
                 dst = &(long_base[write]);
-                MEMCPY (dst, src, size)
                 write = write + size;
+                ARC_TSTP_PUSH(S, iarc, (uint32_t)size);
 
                 /* does the write index is already far, ask for data realignment by the consumer node */
                 i = RD(arc[FMT_ARCW4],PRODUCFMT_ARCW4) * NANOGRAPH_FORMAT_SIZE_W32;
                 producer_frame_size = RD(S->all_formats[i], FRAMESIZE_FMT0);
 
-                if (write > fifosize - producer_frame_size)
-                {   SET_BIT(arc[WR_ARCW3], ALIGNBLCK_ARCW3_LSB);
+                if (write + margin > fifosize - producer_frame_size)    /* room for the next resampled frame */
+                {   SET_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
+                }
+                ARC_WATERMARK(S, iarc, (uint32_t)(write - read), TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB));
+
+                #ifdef IO_COALESCING
+                if (coalesce != 0 && arc_coalesce_hold(S, iarc, (uint32_t)(write - published), (uint32_t)(write - read), 
+                    coalesce, TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB)))
+                {   return;     /* the data stays after the write index */
                 }
+                #endif
             }
         } 
         else /* IO_COMMAND_SET_BUFFER, data holds the address of input in-place access */
         {   
-            /* arc_set_base_address_to_arc */
-            dst = data;
-            ST(arc[BASE_ARCW0], BASEIDXOFFARCW0, lin2pack((intptr_t)data, (uint8_t **)S->long_offset));
-            ST(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1, size);  /* FIFO size aligned with the buffer size */
-            write = size;
+            /* the rebase resets the read index : called by the scheduler running the consumer 
+                of the arc (io_ack_drain, IO_ACK_QUEUE), never from the interrupt of the IO */
+
+            /* ping-pong buffers : the previous buffer is given back to the IO (DMA) with this call, 
+                data not consumed by the graph is lost and counted as an overflow, like a frame 
+                given in several segments */
+            if (write > read || rejected)
+            {   arc_flow_count(&(flow_errors[OVERFLOW_FLOWCNT]));
+            }
+
+            if (rejected)
+            {   dst = 0;    /* the arc keeps its buffer */
+            }
+            else
+            {   /* arc_set_base_address_to_arc */
+                dst = data;
+                size = segment[0].size;
+                ST(arc[BASE_ARCW0], BASEIDXOFFARCW0, lin2pack((intptr_t)data, (uint8_t **)S->long_offset));
+                S->arc_base[iarc] = (uintptr_t)data;
+                ARC_ST_SIZE(S, iarc, size)  /* FIFO size aligned with the buffer size */
+                ARC_ST_READ(S, iarc, 0);
+                read = 0;
+                write = size;
+                ARC_TSTP_PUSH(S, iarc, (uint32_t)size);
+            }
         }
 
         /* reset the data transfert flag is a frame is fully received */
         {   
             uint32_t i, consumer_frame_size;
-            // uint32_t time_stamp_prod, time_stamp_cons;
 
+            /* the time-stamps are not inserted in the data, see ARC_TSTP_PUSH */
             i = NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4);
             consumer_frame_size = RD(S->all_formats[i], FRAMESIZE_FMT0);
 
-            //time_stamp_prod = RD(S->all_formats[i +1], TIMSTAMP_FMT1);
-
-            ///* check the need for time-stamp insertion */
-            //i = RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4) * NANOGRAPH_FORMAT_SIZE_W32;
-            //time_stamp_cons = RD(S->all_formats[i +1], TIMSTAMP_FMT1);
-
-            //if (time_stamp_prod == NO_TIMESTAMP && time_stamp_cons != NO_TIMESTAMP)
-            //{   extern conv_int32_fp32_t graph_global_time_stamp;
-            //    src = dst;
-            //    dst = src + 4;
-            //    MEMCPY (dst, src, size)
-            //    write = write + 4;
-            //    *src = graph_global_time_stamp.u; 
-            //}
-
             /* clear the ongoing" flag when we have enough data */
             if (write - read >= consumer_frame_size)
             {   S->ongoing_async_IO[ongoing_idx] &= ongoing_mask;
             }
         }
 
-        ST(arc[WR_ARCW3], WRITE_ARCW3, write);     /* finaly update the write index */
+        /* finaly publish the new data with the write index, nothing to publish after an overflow (dst=0) */
+        if (dst != 0)
+        {   ARC_ST_WRITE(S, iarc, wr_w32, write)
+            ARC_WR_STORE(S, iarc, wr_w32);
+        }
         if (cache_flush)
-        {   //CLEAN_BUFFER_1LINE(&(arcpt[WR_ARCW3]));    /* MP synchronization */
+        {   //CLEAN_BUFFER_1LINE(&(ARC_WR_W32(S, arcpt)));    /* MP synchronization */
         }
     }
     else 
@@ -243,34 +1189,101 @@ void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
            /* IO_COMMAND_DATA_COPY : reset the ONGOING flag when the remaining data to transmit 
                 is small, and below the transmitter frame size
             */
-            if (write - read < size)   /* data available for TX is too small => underflow */
-            {   /* underflow issue */
-                //platform_al(PLATFORM_ERROR, 0,0,0);
-                /* TODO : implement the flow management desired for "flow_error" */
-                //flow_error = (uint8_t) RD(arc[RD_ARCW2], OVERFLRD_ARCW2);
+            if (write - read < size + margin || rejected)   /* data available for TX is too small => underflow */
+            {   /* underflow issue : the read index is not changed, the IO receives the last frame 
+                    faded-out or a null frame, or nothing is sent */
+                switch (RD(pio_sw_control[IOFMT1], FLOW_RD_IOFMT1))
+                {
+                case FLOW_RD_REPEAT_FADE:
+                    if (read >= size && same_layout)
+                    {   uint32_t i = NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4], CONSUMFMT_ARCW4);
+                        src = &(long_base[read - size]);
+                        dst = data;
+                        MEMCPY (dst, src, size)
+                        arc_flow_crossfade(dst, 0, (uint32_t)size, S->all_formats[i + NCHANDOMAIN_FMT1]);
+                        break;
+                    }
+                    /* no previous frame : null frame */
+                    /* fall through */
+                case FLOW_RD_NULL_FRAME:
+                    for (iseg = 0; iseg < nb_segments; iseg++)
+                    {   MEMSET(segment[iseg].data, 0, segment[iseg].size)
+                    }
+                    break;
+                default:
+                    break;
+                }
+                arc_flow_count(&(flow_errors[UNDERFLOW_FLOWCNT]));
                 size = 0; // write - read;
             }
 
-            /* only one node can read the write-index at a time : no collision is possible */
-            src = &(long_base[read]);
-            dst = data;
-            MEMCPY (dst, src, size)
+            /* only one node can read the write-index at a time : no collision is possible, 
+                the arc data is scattered to the segments */
+            #ifdef IO_DRIFT_COMPENSATION
+            if (drift != 0 && size != 0)
+            {   uint32_t consumed;
+                arc_drift_estimate(drift, (uint32_t)(write - read), (uint32_t)fifosize);
+                for (size = 0, iseg = 0; iseg < nb_segments; iseg++)
+                {   arc_drift_resample(drift, &(long_base[read + size]), (uint32_t)(write - read - size), 
+                        (uint8_t *)(segment[iseg].data), (uint32_t)(segment[iseg].size), drift_fmt1, &consumed);
+                    size = size + consumed;
+                }
+            }
+            else
+            #endif
+            #ifdef IO_FORMAT_CONVERSION
+            if (size != 0 && io_raw != 0)
+            {   io_convert_segments(&(long_base[read]), segment, nb_segments, arc_raw, io_raw, io_swap, 1);
+            }
+            else
+            #endif
+            if (size != 0)
+            {   src = &(long_base[read]);
+                for (iseg = 0; iseg < nb_segments; iseg++)
+                {   dst = (uint8_t *)(segment[iseg].data);
+                    if (planar)
+                    {   io_planar_copy(S, iarc, (uintptr_t)(src - long_base), dst, (uint32_t)(segment[iseg].size), 1);
+                        src = src + segment[iseg].size;
+                        continue;
+                    }
+                    MEMCPY (dst, src, segment[iseg].size)
+                    src = src + segment[iseg].size;
+                }
+            }
             read = read + size;
-            ST(arc[RD_ARCW2], READ_ARCW2, read);   /* update the read index */
+            ARC_ST_READ(S, iarc, read);   /* update the read index */
 
-            /* check need for alignement */
-            if (TEST_BIT (arc[WR_ARCW3], ALIGNBLCK_ARCW3_LSB))
-            {   src = &(long_base[read]);
+            /* check need for alignement, the producer is blocked and the write index is stable : 
+                the TX IO is the consumer of the arc, it owns both indexes while ALIGNBLCK is set */
+            wr_w32 = ARC_WR_LOAD(S, iarc);
+            if (TEST_BIT (wr_w32, ALIGNBLCK_ARCW3_LSB))
+            {   write = ARC_WRITE_W32(S, iarc, wr_w32);
                 dst =  long_base;
-                MEMCPY (dst, src, (uint32_t)(write-read))
+                if (planar)
+                {   uint32_t nchan, stride, ichan;
+
+                    nchan = ARC_NCHAN(S, arc);      /* realignment of each plane */
+                    stride = (uint32_t)(fifosize / nchan);
+                    for (ichan = 0; ichan < nchan; ichan++)
+                    {   src = &(long_base[(ichan * stride) + (read / nchan)]);
+                        dst = &(long_base[ichan * stride]);
+                        MEMCPY (dst, src, (uint32_t)((write - read) / nchan))
+                    }
+                    dst = long_base;
+                }
+                else
+                {   src = &(long_base[read]);
+                    MEMCPY (dst, src, (uint32_t)(write-read))
+                }
 
                 /* update the indexes Read=0, Write=dataLength, then clear the flag */
-                ST(arc[RD_ARCW2], READ_ARCW2, 0);
-                ST(arc[WR_ARCW3], WRITE_ARCW3, write-read);
-                CLEAR_BIT(arc[WR_ARCW3], ALIGNBLCK_ARCW3_LSB);
+                ARC_ST_READ(S, iarc, 0);
+                ARC_ST_WRITE(S, iarc, wr_w32, write-read)
+                CLEAR_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
+                ARC_WR_STORE(S, iarc, wr_w32);
                 if (cache_flush)
                 {   CLEAN_BUFFER_RANGE(dst, write - read);  /* MP synchronization */
-                    //CLEAN_BUFFER_1LINE(&(arcpt[WR_ARCW3]));
+                    //CLEAN_BUFFER_1LINE(&(ARC_WR_W32(S, arcpt)));
                 }
             }
 
@@ -284,26 +1297,169 @@ void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
             }
         } 
         else /* IO_COMMAND_SET_BUFFER, data hold the address for the next frame to send */
-        {
-            /*arc_set_base_address_to_arc */
-            ST(arc[BASE_ARCW0], BASEIDXOFFARCW0, lin2pack((intptr_t)data, (uint8_t **)S->long_offset));
-            ST(arc[RD_ARCW2], READ_ARCW2, 0);
-            ST(arc[WR_ARCW3], WRITE_ARCW3, 0);
+        {   /* both indexes are reset by the scheduler (io_ack_drain, IO_ACK_QUEUE), like the RX rebase */
+            if (rejected)
+            {   arc_flow_count(&(flow_errors[UNDERFLOW_FLOWCNT]));
+            }
+            else
+            {   /*arc_set_base_address_to_arc */
+                ST(arc[BASE_ARCW0], BASEIDXOFFARCW0, lin2pack((intptr_t)data, (uint8_t **)S->long_offset));
+                S->arc_base[iarc] = (uintptr_t)data;
+                ARC_ST_READ(S, iarc, 0);
+                ARC_ST_WRITE(S, iarc, wr_w32, 0)
+                ARC_WR_STORE(S, iarc, wr_w32);
+            }
             S->ongoing_async_IO[ongoing_idx] &= ongoing_mask;
             if (cache_flush)
-            {   // CLEAN_BUFFER_1LINE(&(arcpt[WR_ARCW3]));    /* MP synchronization */
+            {   // CLEAN_BUFFER_1LINE(&(ARC_WR_W32(S, arcpt)));    /* MP synchronization */
             }
         }
 
         /* flush the cache and the memory barriers for buffers used with DMA and multiprocessing */
         if (cache_flush)
-        {   // CLEAN_BUFFER_1LINE(&(arcpt[RD_ARCW2]));    /* MP synchronization */
+        {   // CLEAN_BUFFER_1LINE(&(ARC_RD_W32(S, arcpt)));    /* MP synchronization */
             // CLEAN_BUFFER_RANGE(data, size);
         }
     }
 }
 
 
+/**
+  @brief         data transfer acknowledge, see io_ack_segments()
+  @param[in]     graph_hwio_idx   index of the IO in the platform
+  @param[in]     data             buffer of the IO
+  @param[in]     size             amount of bytes
+  @return        none
+
+  @par           With IO_ACK_QUEUE the acknowledges of the in-place IOs (IO_COMMAND_SET_BUFFER) 
+                 are posted : the rebase of the arc is made by the scheduler in io_ack_drain(), 
+                 the IO never stores the index owned by the other side of the arc. Without the 
+                 queue they must be called from the context of the scheduler.
+ */
+void NanoGraph_io_ack (uint8_t graph_hwio_idx, void *data, uintptr_t size)
+{
+    nanograph_io_segment_t segment;
+
+#ifdef IO_ACK_QUEUE
+    /* the producer of an arc never stores its read index : the scheduler rebases in-place IOs */
+    if (io_ack_in_place(graph_hwio_idx))
+    {   NanoGraph_io_ack_post(graph_hwio_idx, data, size);
+        return;
+    }
+#endif
+    segment.data = data;
+    segment.size = size;
+    io_ack_segments(graph_hwio_idx, &segment, 1);
+    IO_RECORD_EVENT(IO_EVENT_ACK, graph_hwio_idx, &segment, 1);
+}
+
+
+/**
+  @brief         vectored data transfer acknowledge
+  @param[in]     graph_hwio_idx   index of the IO in the platform
+  @param[in]     segment          buffers of the frame, in order (DMA descriptors)
+  @param[in]     nb_segments      number of segments, at least one
+  @return        none
+
+  @par           The frame is copied between the segments and the arc without staging buffer. 
+                 The flow errors are checked on the total size : the crossfade and the repeat 
+                 of the last frame are replaced by a lost frame and a null frame. An in-place 
+                 IO maps a single buffer : a frame of several segments is rejected and counted 
+                 as an overflow (RX) or an underflow (TX), the rebase is posted like in 
+                 NanoGraph_io_ack(). For planar arcs each segment holds whole samples of all 
+                 the channels, else the frame is rejected the same way.
+ */
+void NanoGraph_io_ackv (uint8_t graph_hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments)
+{
+    if (nb_segments == 0)
+    {   return;
+    }
+#ifdef IO_ACK_QUEUE
+    if (io_ack_in_place(graph_hwio_idx))
+    {   if (nb_segments > 1)
+        {   NanoGraph_io_ack_post(graph_hwio_idx, 0, 0);    /* rejected and counted by the scheduler */
+        }
+        else
+        {   NanoGraph_io_ack_post(graph_hwio_idx, segment[0].data, segment[0].size);
+        }
+        return;
+    }
+#endif
+    io_ack_segments(graph_hwio_idx, segment, nb_segments);
+    IO_RECORD_EVENT(IO_EVENT_ACK, graph_hwio_idx, segment, nb_segments);
+}
+
+
+
+/**
+  @brief         acknowledge posted from an interrupt
+  @param[in]     graph_hwio_idx   index of the IO in the platform
+  @param[in]     data             buffer of the IO
+  @param[in]     size             amount of bytes
+  @return        none
+
+  @par           The ISR only writes a descriptor in the queue of the instance, the data copy or 
+                 the rebase of the arc is made by NanoGraph_io_ack() from io_ack_drain() at the 
+                 start of the next pass of the scheduler. The buffer must stay valid until then 
+                 (ping-pong DMA halves). When the queue is full the acknowledge is dropped and 
+                 counted in io_ack_overflow, the ISR never copies data.
+                 The queue has a single producer : the ISRs posting to the same instance must 
+                 not preempt each other (same interrupt priority).
+                 Without IO_ACK_QUEUE the acknowledge is processed in the context of the caller.
+ */
+void NanoGraph_io_ack_post (uint8_t graph_hwio_idx, void *data, uintptr_t size)
+{
+    nanograph_io_segment_t segment;
+#ifdef IO_ACK_QUEUE
+    nanograph_instance_t *S = io_ack_instance(graph_hwio_idx);
+    nanograph_io_ack_t *slot;
+    uint32_t posted;
+#endif
+
+    segment.data = data;
+    segment.size = size;
+    IO_RECORD_EVENT(IO_EVENT_POST, graph_hwio_idx, &segment, 1);
+
+#ifdef IO_ACK_QUEUE
+    posted = S->io_ack_posted;
+    if (posted - ARC_LOAD_ACQUIRE(S->io_ack_drained) >= IO_ACK_QUEUE)
+    {   S->io_ack_overflow++;
+        return;
+    }
+    slot = &(S->io_ack_queue[posted & (IO_ACK_QUEUE - 1u)]);
+    slot->data = data;
+    slot->size = size;
+    slot->hwio_idx = graph_hwio_idx;
+    ARC_STORE_RELEASE(S->io_ack_posted, posted + 1u);
+#else
+    io_ack_segments(graph_hwio_idx, &segment, 1);
+#endif
+}
+
+
+/**
+  @brief         process the acknowledges posted by the ISRs
+  @param[in]     S          instance
+  @return        none
+ */
+#ifdef IO_ACK_QUEUE
+void io_ack_drain (nanograph_instance_t *S)
+{
+    nanograph_io_ack_t *slot;
+    nanograph_io_segment_t segment;
+    uint32_t posted, drained;
+
+    posted = ARC_LOAD_ACQUIRE(S->io_ack_posted);
+    for (drained = S->io_ack_drained; drained != posted; drained++)
+    {   slot = &(S->io_ack_queue[drained & (IO_ACK_QUEUE - 1u)]);
+        segment.data = slot->data;
+        segment.size = slot->size;
+        io_ack_segments(slot->hwio_idx, &segment, 1);     /* recorded when posted */
+        ARC_STORE_RELEASE(S->io_ack_drained, drained + 1u);
+    }
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -132,6 +132,183 @@ uint32_t * read_graph_and_copy (nanograph_instance_t *S, uint32_t *graph, uint8_
     return graph_dst;
 }
 
+#ifdef ARC_PLANAR
+/**
+  @brief        size of a planar arc cut in planes
+  @param[in]    S          instance
+  @param[in]    iarc       index of the arc (PLANAR_ARCW4 = 1)
+  @return       none
+
+  @par          The size is truncated to nchan planes of PLANE_ALIGNMENT_BYTES multiples, 
+                after the reset and after an IO gives the buffer of the arc.
+ */
+static void arc_planar_size (nanograph_instance_t *S, uint32_t iarc)
+{
+    uint32_t nchan, stride;
+
+    nchan = ARC_NCHAN(S, ARC_DESC(S, iarc));
+    stride = ARC_SIZE(S, iarc) / nchan;
+    stride = stride & ~(U(PLANE_ALIGNMENT_BYTES) - 1u);
+    ARC_ST_SIZE(S, iarc, stride * nchan)
+}
+#endif
+
+/**
+  @brief        initialize the table of arc base addresses
+  @param[in]    S          instance
+  @param[in]    narc       number of arcs in the graph, at most MAX_NB_ARCS (checked by the caller)
+  @return       none
+
+  @par          The packed addresses BASE_ARCW0 are translated once to the memory map of 
+                this processor. The scheduler reads the linear address with ARC_BASE().
+                The table is updated when an IO changes the base address of its arc.
+                The flow error counters, the occupancy watermarks, the time-stamp rings, the 
+                RX staging and the drift compensation states of the arcs are cleared.
+                The arcs with a FMT_DEINTERLEAVED_PLANAR consumer format are planar (ARC_PLANAR),
+                their size is truncated to nchan planes of PLANE_ALIGNMENT_BYTES multiples, the 
+                base address given by the graph compiler is aligned.
+ */
+static void init_arc_base_addresses (nanograph_instance_t *S, uint32_t narc)
+{
+    uint32_t iarc, *arc;
+
+    for (iarc = 0; iarc < narc; iarc++)
+    {   arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * iarc]);
+        S->arc_flow_errors[SIZEOF_FLOWCNT_W32 * iarc + OVERFLOW_FLOWCNT] = 0;
+        S->arc_flow_errors[SIZEOF_FLOWCNT_W32 * iarc + UNDERFLOW_FLOWCNT] = 0;
+#ifdef ARC_WATERMARKS
+        S->arc_watermarks[iarc] = 0;
+#endif
+#ifdef ARC_TIMESTAMPS
+        MEMSET(&(S->arc_time_stamps[SIZEOF_ARCTSTP_W32 * iarc]), 0, 4 * SIZEOF_ARCTSTP_W32)
+#endif
+#ifdef IO_COALESCING
+        MEMSET(&(S->arc_staging[SIZEOF_ARCSTG_W32 * iarc]), 0, 4 * SIZEOF_ARCSTG_W32)
+#endif
+#ifdef IO_DRIFT_COMPENSATION
+        MEMSET(&(S->arc_drift[SIZEOF_ARCDRIFT_W32 * iarc]), 0, 4 * SIZEOF_ARCDRIFT_W32)
+        S->arc_drift[SIZEOF_ARCDRIFT_W32 * iarc + STEP_DRIFT] = DRIFT_UNITY;
+#endif
+        pack2lin(&(S->arc_base[iarc]), arc[BASE_ARCW0], S->long_offset);
+
+#ifdef ARC_PLANAR
+        CLEAR_BIT(arc[FMT_ARCW4], PLANAR_ARCW4_LSB);
+        if (FMT_DEINTERLEAVED_PLANAR == RD(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4) + NCHANDOMAIN_FMT1], INTERLEAV_FMT1) &&
+            ARC_NCHAN(S, arc) <= MAX_NB_PLANAR_CHANNELS)    /* else too many channels for the node tables, the arc stays interleaved */
+        {   SET_BIT(arc[FMT_ARCW4], PLANAR_ARCW4_LSB);
+            arc_planar_size(S, iarc);
+        }
+#endif
+    }
+}
+
+#ifdef ARC_EXTENDED
+/**
+  @brief        initialize the table of the 32-bit sizes and indexes of the extended arcs
+  @param[in]    S          instance
+  @param[in]    narc       number of arcs in the graph, at most MAX_NB_ARCS (checked by the caller)
+  @return       none
+
+  @par          The extended arcs (EXTDESC_ARCW3) give their buffer size in BUFF_SIZE_ARCW1 with
+                the format SIZE_EXT_FMT0 : SIZE_FMT0 << (2 x EXTENSION_FMT0). The R/W indexes 
+                start from READ_ARCW2/WRITE_ARCW3. Only the main instance initializes the table, 
+                the other instances share it.
+ */
+static void init_arc_extended (nanograph_instance_t *S, uint32_t narc)
+{
+    uint32_t iarc, *arc;
+
+    for (iarc = 0; iarc < narc; iarc++)
+    {   arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * iarc]);
+        if (0 == ARC_IS_EXT(S, iarc) || GLOBAL_MAIN_INSTANCE != RD(S->scheduler_control, MAININST_SCTRL))
+        {   continue;
+        }
+        ARC_XW32(S, iarc, XSIZE_ARCXW0) = RD(arc[SIZE_ARCW1], SIZE_FMT0) << (2 * RD(arc[SIZE_ARCW1], EXTENSION_FMT0));
+        ARC_XW32(S, iarc, XREAD_ARCXW1) = RD(arc[RD_ARCW2], READ_ARCW2);
+        ARC_XW32(S, iarc, XWRITE_ARCXW2) = RD(arc[WR_ARCW3], WRITE_ARCW3);
+    }
+}
+#endif
+
+#ifdef ARC_HOT_COLD_SPLIT
+/**
+  @brief        initialize the table of arc R/W indexes
+  @param[in]    S          instance
+  @param[in]    arc_hot    table provided by the platform
+  @param[in]    narc       number of arcs in the graph, at most MAX_NB_ARCS (checked by the caller)
+  @return       none
+
+  @par          The table is aligned on a cache line and loaded with the indexes set by the
+                graph compiler in RD_ARCW2/WR_ARCW3. Only the main instance initializes the table,
+                the other instances share it.
+ */
+static void init_arc_hot_indexes (nanograph_instance_t *S, uint32_t *arc_hot, uint32_t narc)
+{
+    uint32_t iarc, *arc, *hot;
+
+#if CACHE_LINE_BYTE_LENGTH > 0
+    arc_hot = (uint32_t *)(((uintptr_t)arc_hot + CACHE_LINE_BYTE_LENGTH - 1) & ~(uintptr_t)(CACHE_LINE_BYTE_LENGTH - 1));
+#endif
+    S->arc_hot = arc_hot;
+
+    if (GLOBAL_MAIN_INSTANCE != RD(S->scheduler_control, MAININST_SCTRL))
+    {   return;
+    }
+
+    for (iarc = 0; iarc < narc; iarc++)
+    {   arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * iarc]);
+        hot = &(arc_hot[SIZEOF_ARCHOT_W32 * iarc]);
+        hot[CTRL_HOTW0] = 0;
+        hot[RD_HOTW1] = arc[RD_ARCW2];
+        hot[WR_HOTW2] = arc[WR_ARCW3];
+    }
+    CLEAN_BUFFER_RANGE(arc_hot, narc * SIZEOF_ARCHOT_W32 * 4);
+}
+#endif
+
+/**
+  @brief        initialize the history of the arcs
+  @param[in]    S          instance
+  @param[in]    narc       number of arcs in the graph
+  @param[in]    nformat    number of formats in the graph
+  @return       0 when the graph is accepted, else ERROR_LOG_HISTORY
+
+  @par          The empty arcs with a consumer format asking for history (HISTORY_FMT0) start 
+                with null data before the read index, the consumer can index backward from 
+                the read address from the first call. Only the main instance initializes the arcs.
+                The formats of the arcs are in the table of formats, the history and one frame
+                of the producer fit in the buffer : the realignment keeps "history" bytes before
+                the read index and the producer writes its frame after the data.
+ */
+uint32_t arc_history_init (nanograph_instance_t *S, uint32_t narc, uint32_t nformat)
+{
+    uint32_t iarc, *arc, history, frame, wr_w32;
+
+    for (iarc = 0; iarc < narc; iarc++)
+    {   arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * iarc]);
+        if (RD(arc[FMT_ARCW4], CONSUMFMT_ARCW4) >= nformat || RD(arc[FMT_ARCW4], PRODUCFMT_ARCW4) >= nformat)
+        {   return ERROR_LOG_HISTORY;
+        }
+        history = nanograph_history_bytes(&(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4)]));
+        frame = RD(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],PRODUCFMT_ARCW4) + FRAMESZ_FMT0], FRAMESIZE_FMT0);
+        if (history == 0)
+        {   continue;
+        }
+        if (history + frame > ARC_SIZE(S, iarc))
+        {   return ERROR_LOG_HISTORY;
+        }
+        if (GLOBAL_MAIN_INSTANCE != RD(S->scheduler_control, MAININST_SCTRL) || 0 != ARC_READ(S, iarc) || 0 != ARC_WRITE(S, iarc))
+        {   continue;
+        }
+        MEMSET(ARC_BASE(S, iarc), 0, history)
+        ARC_ST_READ(S, iarc, history);
+        wr_w32 = ARC_WR_LOAD(S, iarc);
+        ARC_ST_WRITE(S, iarc, wr_w32, history)
+        ARC_WR_STORE(S, iarc, wr_w32);
+    }
+    return 0;
+}
+
 /**
   @brief            (main) demonstration
   @param[in/out]    none
@@ -146,11 +323,12 @@ uint32_t * read_graph_and_copy (nanograph_instance_t *S, uint32_t *graph, uint8_
 void platform_init_nanograph_instance(nanograph_instance_t *S)
 {
     uint32_t *graph_input;
-    uint32_t hwnio;
+    uint32_t hwnio, narc, nformat, i;
     NanoGraph_init_t platform_specific_data;
 
     ST(S->scheduler_control, RSTSTATE_SCTRL, RSTSTATE_START);        /* instance enters RESET state */
 
+    MEMSET(&platform_specific_data, 0, sizeof(NanoGraph_init_t))    /* tables of the options not selected stay null */
     platform_init_specific(&platform_specific_data);
 
     /* set the whoamI fields */
@@ -171,6 +349,20 @@ void platform_init_nanograph_instance(nanograph_instance_t *S)
     S->node_entry_points = (const p_nanograph_node *)platform_specific_data.node_entry_points;
 
     S->new_parameters = platform_specific_data.new_parameters;
+    S->arc_base = platform_specific_data.arc_base;
+    S->arc_extended = platform_specific_data.arc_extended;
+    S->arc_flow_errors = platform_specific_data.arc_flow_errors;
+    S->arc_watermarks = platform_specific_data.arc_watermarks;
+    S->arc_time_stamps = platform_specific_data.arc_time_stamps;
+    S->arc_staging = platform_specific_data.arc_staging;
+    S->arc_drift = platform_specific_data.arc_drift;
+#ifdef IO_ACK_QUEUE
+    S->io_ack_posted = 0;
+    S->io_ack_drained = 0;
+    S->io_ack_overflow = 0;
+#endif
+    S->arc_pool = platform_specific_data.arc_pool;
+    S->arc_pool_free = platform_specific_data.arc_pool_size;
 
     S->pio_hw      = read_graph_and_copy(S, graph_input, GRAPH_PIO_HW);     // IO provided by the platform
 
@@ -181,8 +373,46 @@ void platform_init_nanograph_instance(nanograph_instance_t *S)
     S->script      = read_graph_and_copy(S, graph_input, GRAPH_SCRIPTS);      
     S->linked_list = read_graph_and_copy(S, graph_input, GRAPH_LINKED_LIST);       
     S->all_formats = read_graph_and_copy(S, graph_input, GRAPH_FORMATS);         
-    S->all_arcs    = read_graph_and_copy(S, graph_input, GRAPH_ARCS);               
-  
+    S->all_arcs    = read_graph_and_copy(S, graph_input, GRAPH_ARCS);
+
+    /* the per-arc tables of the platform are indexed with the arc index without check */
+    narc = graph_input[GRAPH_HEADER_NBWORDS + GRAPH_ARCS *2 + SECTION_SIZE] / SIZEOF_ARCDESC_W32;
+    if (narc > MAX_NB_ARCS)
+    {   S->error_log |= ERROR_LOG_NB_ARCS;
+        return;
+    }
+
+    /* the IO acknowledges index the per-arc tables with IOARCID_IOFMT0, from interrupts, without check */
+    for (i = 0; i < S->nb_graph_io; i++)
+    {   if (RD(S->pio_graph[i * NANOGRAPH_IOFMT_SIZE_W32], IOARCID_IOFMT0) >= narc)
+        {   S->error_log |= ERROR_LOG_IO_ARC;
+            return;
+        }
+    }
+
+    /* the arcs index the table of formats with CONSUMFMT_ARCW4 and PRODUCFMT_ARCW4 from the reset */
+    nformat = graph_input[GRAPH_HEADER_NBWORDS + GRAPH_FORMATS *2 + SECTION_SIZE] / NANOGRAPH_FORMAT_SIZE_W32;
+    for (i = 0; i < narc; i++)
+    {   if (RD(S->all_arcs[SIZEOF_ARCDESC_W32 * i + FMT_ARCW4], CONSUMFMT_ARCW4) >= nformat ||
+            RD(S->all_arcs[SIZEOF_ARCDESC_W32 * i + FMT_ARCW4], PRODUCFMT_ARCW4) >= nformat)
+        {   S->error_log |= ERROR_LOG_ARC_FMT;
+            return;
+        }
+    }
+#ifdef ARC_EXTENDED
+    init_arc_extended(S, narc);
+#endif
+    init_arc_base_addresses(S, narc);
+#ifdef ARC_HOT_COLD_SPLIT
+    init_arc_hot_indexes(S, platform_specific_data.arc_hot, narc);
+#endif
+
+    /* the history before the read index is addressed with the formats of the arcs, without check */
+    S->error_log |= arc_history_init(S, narc, nformat);
+    if (0 != S->error_log)
+    {   return;
+    }
+
     ST(S->link_offset, NODE_LINK_W32OFF, 0);      /* reset the read index in the linked list */
 
     /* the iomask of each instance is used to know who initializes which IO, one processor per I/O */
@@ -198,7 +428,7 @@ void platform_init_nanograph_instance(nanograph_instance_t *S)
 /*----------------------------------------------------------------------------
     convert a physical address to a portable multiprocessor address 
  *----------------------------------------------------------------------------*/
-static uint32_t lin2pack (intptr_t buffer, uint8_t ** long_offset)
+uint32_t lin2pack (intptr_t buffer, uint8_t ** long_offset)
 {
     intptr_t distance;
     uint32_t ret;
@@ -289,6 +519,14 @@ void platform_init_io(nanograph_instance_t *S, uint32_t hwnio)
 
         (*io_func)(NANOGRAPH_RESET, &io_setting);
 
+#ifdef ARC_PLANAR
+        /* the in-place IOs (RX and TX) give their own buffers with the interleaved layout of the IO */
+        if (IO_COMMAND_SET_BUFFER == RD(*pio_control, SET0COPY1_IOFMT0))
+        {   arc = &(all_arcs[SIZEOF_ARCDESC_W32 * RD(*pio_control, IOARCID_IOFMT0)]);
+            CLEAR_BIT(arc[FMT_ARCW4], PLANAR_ARCW4_LSB);
+        }
+#endif
+
         /* 
             IO-Interface expects the buffer to be declared outside of the graph
             
@@ -298,15 +536,31 @@ void platform_init_io(nanograph_instance_t *S, uint32_t hwnio)
         {   
             nanograph_xdmbuffer_t pt_pt;
             io_func = &(S->platform_io[RD(*pio_control, FWIOIDX_IOFMT0)]);
+            pt_pt.address = 0;
+            pt_pt.size = 0;
             (*io_func)(NANOGRAPH_SET_BUFFER, &pt_pt);
 
+            /* no buffer (file not mapped, ring not attached) : the arc is not rebased on address 0 */
+            if (pt_pt.address == 0 || pt_pt.size == 0)
+            {   S->error_log |= ERROR_LOG_IO_BUFFER;
+                continue;
+            }
+
             iarc = RD(*pio_control, IOARCID_IOFMT0);
-            iarc = SIZEOF_ARCDESC_W32 * iarc;
-            arc = &(all_arcs[iarc]);
+            arc = &(all_arcs[SIZEOF_ARCDESC_W32 * iarc]);
             ST(arc[BASE_ARCW0], BASEIDXOFFARCW0, lin2pack(pt_pt.address, (uint8_t **)S->long_offset));
-            ST(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1, pt_pt.size);
-            ST(arc[RD_ARCW2], READ_ARCW2, 0);
-            ST(arc[WR_ARCW3], WRITE_ARCW3, 0);
+            S->arc_base[iarc] = (uintptr_t)(pt_pt.address);
+            ARC_ST_SIZE(S, iarc, pt_pt.size)
+#ifdef ARC_PLANAR
+            if (ARC_IS_PLANAR(arc))     /* buffer of a copying IO : the planes are cut again */
+            {   arc_planar_size(S, iarc);
+            }
+#endif
+            ARC_ST_READ(S, iarc, 0);
+            {   uint32_t wr_w32 = ARC_WR_LOAD(S, iarc);
+                ARC_ST_WRITE(S, iarc, wr_w32, 0)
+                ARC_WR_STORE(S, iarc, wr_w32);
+            }
         }
     } 
 }
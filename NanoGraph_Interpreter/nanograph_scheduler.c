@@ -43,9 +43,9 @@ static void set_reset_parameters (nanograph_instance_t *S, uint32_t *ptr_param32
 static void upload_new_parameters (nanograph_instance_t *S);
 
 static void run_node (nanograph_instance_t *S);
-static uint8_t arc_ready_for_write(nanograph_instance_t *S, uint32_t *arc, uintptr_t *frame_size);
-static uint8_t arc_ready_for_read(nanograph_instance_t *S, uint32_t *arc, uintptr_t *frame_size);
-static intptr_t arc_extract_info_int (uint32_t *arc, uint8_t tag);
+static uint8_t arc_ready_for_write(nanograph_instance_t *S, uint32_t iarc, uintptr_t *frame_size);
+static uint8_t arc_ready_for_read(nanograph_instance_t *S, uint32_t iarc, uintptr_t *frame_size);
+static intptr_t arc_extract_info_int (nanograph_instance_t *S, uint32_t iarc, uint8_t tag);
 static void load_clear_memory_segments (nanograph_instance_t *S, uint8_t pre0post1);
 static void check_graph_boundaries(nanograph_instance_t *S);
 
@@ -136,7 +136,8 @@ static void script_processing(uint32_t script_index, uint32_t parameter)
 
 /**
   @brief         Tool box : Arc descriptor fields extraction, returns an integer
-  @param[in]     arc        pointer to the arc descriptor to read
+  @param[in]     instance   global data of the instance
+  @param[in]     iarc       index of the arc to read
   @param[in]     command    operation to do
   @return        int
 
@@ -145,16 +146,16 @@ static void script_processing(uint32_t script_index, uint32_t parameter)
   @remark
  */
 
-static intptr_t arc_extract_info_int (uint32_t *arc, uint8_t tag)
+static intptr_t arc_extract_info_int (nanograph_instance_t *S, uint32_t iarc, uint8_t tag)
 {
     uint32_t read;
     uint32_t write;
     uint32_t size;
     intptr_t ret;
 
-    read =  RD(arc[RD_ARCW2], READ_ARCW2);
-    write = RD(arc[WR_ARCW3], WRITE_ARCW3);
-    size =  RD(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1);
+    read =  ARC_READ(S, iarc);
+    write = ARC_WRITE(S, iarc);
+    size =  ARC_SIZE(S, iarc);
 
     switch (tag)
     {
@@ -170,7 +171,7 @@ static intptr_t arc_extract_info_int (uint32_t *arc, uint8_t tag)
 /**
   @brief         Arc descriptor fields extraction, returns a byte pointer
   @param[in]     instance   global data of the instance
-  @param[in]     arc        pointer to the arc descriptor to read
+  @param[in]     iarc       index of the arc to read
   @param[in]     command    operation to do
   @return        uint8 *    data pointer 
 
@@ -179,18 +180,16 @@ static intptr_t arc_extract_info_int (uint32_t *arc, uint8_t tag)
   @remark
  */
 
-static uint8_t * arc_extract_info_pt (nanograph_instance_t *S, uint32_t *arc, uint8_t tag)
+static uint8_t * arc_extract_info_pt (nanograph_instance_t *S, uint32_t iarc, uint8_t tag)
 {
     uintptr_t read;
     uintptr_t write;
-    uintptr_t long_base;
     uint8_t *ret, *base;
 
     /* read the base address of the FIFO buffer */
-    pack2lin(&long_base, arc[BASE_ARCW0], (S->long_offset));
-    base = (uint8_t *)long_base;
-    read =  RD(arc[RD_ARCW2], READ_ARCW2);
-    write = RD(arc[WR_ARCW3], WRITE_ARCW3);
+    base = ARC_BASE(S, iarc);
+    read =  ARC_READ(S, iarc);
+    write = ARC_WRITE(S, iarc);
 
     switch (tag)
     {
@@ -204,11 +203,85 @@ static uint8_t * arc_extract_info_pt (nanograph_instance_t *S, uint32_t *arc, ui
 }
 
 
+#ifdef ARC_PLANAR
+/**
+  @brief         Channel addresses of a planar arc
+  @param[in]     instance   global data of the instance
+  @param[in]     iarc       index of the arc (PLANAR_ARCW4 = 1)
+  @param[in]     index      read or write index of the arc
+  @param[out]    ptr        table of MAX_NB_PLANAR_CHANNELS channel addresses
+  @return        none
+
+  @par           The planes are spaced by BUFF_SIZE / nchan, the index of the arc counts the 
+                 bytes of all the channels, the position in each plane is index / nchan.
+  @remark
+ */
+
+static void arc_planar_pointers (nanograph_instance_t *S, uint32_t iarc, uintptr_t index, intptr_t *ptr)
+{
+    uint32_t nchan, stride, ichan, *arc;
+    uint8_t *base;
+
+    arc = ARC_DESC(S, iarc);
+    base = ARC_BASE(S, iarc);
+    nchan = ARC_NCHAN(S, arc);
+    stride = ARC_SIZE(S, iarc) / nchan;
+
+    for (ichan = 0; ichan < nchan; ichan++)
+    {   ptr[ichan] = (intptr_t)(base + (ichan * stride) + (index / nchan));
+    }
+}
+#endif
+
+
+#ifdef ARC_TIMESTAMPS
+/**
+  @brief         Time-stamp of the data at the read index of an arc
+  @param[in]     instance   global data of the instance
+  @param[in]     iarc       index of the arc
+  @param[out]    offset     bytes from the start of the time-stamped frame to the read index
+  @return        time-stamp of the frame, 0 when the ring is empty
+
+  @par           The ring is parsed from the newest frame, the first one starting at or before 
+                 the stream position of the read index is selected. When the consumer is more 
+                 than ARC_TSTP_RING frames late the oldest frame of the ring is used.
+  @remark
+ */
+
+static uint32_t arc_time_stamp_lookup (nanograph_instance_t *S, uint32_t iarc, uint32_t *offset)
+{
+    uint32_t *ring, position, npush, nframes, i, entry;
+
+    ring = &(S->arc_time_stamps[SIZEOF_ARCTSTP_W32 * iarc]);
+    npush = ring[NPUSH_ARCTSTP];
+    position = ring[RDPOS_ARCTSTP];
+    *offset = 0;
+    if (npush == 0)
+    {   return 0;
+    }
+
+    nframes = MIN(npush, ARC_TSTP_RING);
+    entry = RING_ARCTSTP;
+    for (i = 1; i <= nframes; i++)
+    {   entry = RING_ARCTSTP + 2u * ((npush - i) & (ARC_TSTP_RING - 1u));
+        if ((int32_t)(position - ring[entry]) >= 0)
+        {   break;
+        }
+    }
+    if ((int32_t)(position - ring[entry]) > 0)
+    {   *offset = position - ring[entry];
+    }
+    return ring[entry + 1u];
+}
+#endif
+
+
 /**
   @brief         Set the "need of data alignment bit" of the arc
   @param[in]     format     pointer to the table of formats
-  @param[in/out] arc        pointer to the arc to check 
-  @return        none
+  @param[in]     iarc       index of the arc to check 
+  @param[in]     wr_w32     write index word to update
+  @return        the write index word, published by the caller with ARC_WR_STORE
 
   @par           The arc descriptor gives, in the 1st word, the stream format used by
                  the node producing data to this arc.
@@ -222,39 +295,41 @@ static uint8_t * arc_extract_info_pt (nanograph_instance_t *S, uint32_t *arc, ui
 
   @remark
  */
-static void set_alignment_bit (nanograph_instance_t *S, uint32_t *arc)
+static uint32_t set_alignment_bit (nanograph_instance_t *S, uint32_t iarc, uint32_t wr_w32)
 {
+    uint32_t *arc = ARC_DESC(S, iarc);
     uint32_t producer_frame_size, fifosize, write;
     uint32_t i;
 
-    fifosize =  RD(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1);
-    write = RD(arc[WR_ARCW3], WRITE_ARCW3);
+    fifosize =  ARC_SIZE(S, iarc);
+    write = ARC_WRITE_W32(S, iarc, wr_w32);
 
     /* does the write index is already far, to ask for data realignment? */
     i = (uint8_t) RD(arc[FMT_ARCW4],PRODUCFMT_ARCW4);
     i = i * NANOGRAPH_FORMAT_SIZE_W32;
-    producer_frame_size = RD(S->all_formats[i], FRAMESIZE_FMT0);
+    producer_frame_size = RD(S->all_formats[i], FRAMESIZE_FMT0) + ARC_MSG_OVERHEAD(arc);
 
     /* the consumer reset this bit after data realignment */
     if (fifosize < producer_frame_size + write)
         {
-            SET_BIT(arc[WR_ARCW3], ALIGNBLCK_ARCW3_LSB);
+            SET_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
     }
     else
     {   
         /* the realignment bit was set, clear it and notify the producer */
-        if (arc[WR_ARCW3] & (1 << ALIGNBLCK_ARCW3_LSB))
+        if (wr_w32 & (1 << ALIGNBLCK_ARCW3_LSB))
             {
-                CLEAR_BIT(arc[WR_ARCW3], ALIGNBLCK_ARCW3_LSB);
+                CLEAR_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB);
         }
     }
+    return wr_w32;
 }
 
 
 /**
   @brief         Checks the producer node can use this arc
   @param[in]     instance   global registers of this instance
-  @param[in]     arc        arc to check
+  @param[in]     iarc       index of the arc to check
   @return        none
 
   @par           The arc descriptor gives, in the 1st word, the stream format used by
@@ -265,18 +340,19 @@ static void set_alignment_bit (nanograph_instance_t *S, uint32_t *arc)
   @remark
  */
 
-static uint8_t arc_ready_for_write(nanograph_instance_t *S, uint32_t *arc, uintptr_t *free_for_writes)
+static uint8_t arc_ready_for_write(nanograph_instance_t *S, uint32_t iarc, uintptr_t *free_for_writes)
 {
     uint32_t producer_frame_size;   
     uint8_t ret;
-    uint32_t fifosize, write, *all_formats, i;
+    uint32_t fifosize, write, *all_formats, i, *arc;
 
     all_formats = S->all_formats;
-    write = RD(arc[WR_ARCW3], WRITE_ARCW3);
-    fifosize = RD(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1);
+    arc = ARC_DESC(S, iarc);
+    write = ARC_WRITE(S, iarc);
+    fifosize = ARC_SIZE(S, iarc);
   
     i = NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],PRODUCFMT_ARCW4);
-    producer_frame_size = RD(all_formats[i], FRAMESIZE_FMT0);
+    producer_frame_size = RD(all_formats[i], FRAMESIZE_FMT0) + ARC_MSG_OVERHEAD(arc);
 
     *free_for_writes =  (uint32_t)(fifosize - write); /* memory available for writes */
 
@@ -296,30 +372,34 @@ static uint8_t arc_ready_for_write(nanograph_instance_t *S, uint32_t *arc, uintp
 /**
   @brief         Checks the consumer node can use this arc
   @param[in]     instance   global registers of this instance
-  @param[in]     arc        arc to check
+  @param[in]     iarc       index of the arc to check
   @return        none
 
   @par           The arc descriptor gives, in the 2nd word, the stream format used by
                  the node consuming data from this arc.
                  Looking at the amount of data in the buffer and the frame-size
                  consumer by the node (the minimum amount of byte consumed per call), the
-                 function returns a go/no-go flag.
+                 function returns a go/no-go flag. Message arcs are ready with one message.
   @remark
  */
 
-static uint8_t arc_ready_for_read(nanograph_instance_t *S, uint32_t *arc, uintptr_t *frame_size)
+static uint8_t arc_ready_for_read(nanograph_instance_t *S, uint32_t iarc, uintptr_t *frame_size)
 {
     uint32_t consumer_frame_size, consumer_frame_format;   
     uintptr_t read, write;
-    uint32_t *all_formats;
+    uint32_t *all_formats, *arc;
     uint8_t ret;
 
     all_formats = S->all_formats;
-    read = RD(arc[RD_ARCW2], READ_ARCW2);
-    write = RD(arc[WR_ARCW3], WRITE_ARCW3);
+    arc = ARC_DESC(S, iarc);
+    read = ARC_READ(S, iarc);
+    write = ARC_WRITE(S, iarc);
 
     consumer_frame_format = all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4)];
     consumer_frame_size = RD(consumer_frame_format, FRAMESIZE_FMT0);
+    if (TEST_BIT(arc[FMT_ARCW4], MESSAGE_ARCW4_LSB))
+    {   consumer_frame_size = MSG_HEADER_BYTES;      /* ready with one message */
+    }
     *frame_size = (uint32_t)(write - read);     /* size of data ready for read */
 
     if (*frame_size >= consumer_frame_size)
@@ -336,23 +416,143 @@ static uint8_t arc_ready_for_read(nanograph_instance_t *S, uint32_t *arc, uintpt
 
 
 
+#ifdef ARC_WATERMARKS
+/**
+  @brief         Update the occupancy watermarks of an arc
+  @param[in]     instance   global data of the instance
+  @param[in]     iarc       index of the arc
+  @param[in]     occupancy  amount of data in the arc, in bytes
+  @param[in]     nearfull   1 when less than one producer frame of free space is left
+  @return        none
+
+  @par           Called from the scheduler after the node production and from NanoGraph_io_ack()
+                 with ARC_WATERMARK(), when ARC_WATERMARKS is defined.
+  @remark
+ */
+
+void arc_watermark_update (nanograph_instance_t *S, uint32_t iarc, uint32_t occupancy, uint8_t nearfull)
+{
+    uint32_t *wmark;
+
+    wmark = &(S->arc_watermarks[iarc]);
+    if (occupancy > RD(*wmark, PEAK_WMARK))
+    {   ST(*wmark, PEAK_WMARK, occupancy);
+    }
+    if (nearfull && RD(*wmark, NEARFULL_WMARK) < (1u << (NEARFULL_WMARK_MSB - NEARFULL_WMARK_LSB + 1)) - 1u)
+    {   *wmark += 1u << NEARFULL_WMARK_LSB;
+    }
+}
+
+
+/**
+  @brief         Recommended sizes of the arc buffers
+  @param[in]     instance   global data of the instance
+  @param[out]    sizes      table of BUFF_SIZE values in bytes
+  @param[in]     narc       number of arcs
+  @return        none
+
+  @par           The recommendation is the peak occupancy plus the consumer history and one 
+                 producer frame. The arcs which were found near full keep at least their current 
+                 size plus one producer frame. Arcs without measurement keep their current size.
+                 The values are to be copied to the arc sizes of the graph.
+  @remark
+ */
+
+void arc_recommended_sizes (nanograph_instance_t *S, uint32_t *sizes, uint32_t narc)
+{
+    uint32_t iarc, *arc, fifosize, producer_frame_size, wmark, recommended;
+
+    narc = MIN(narc, MAX_NB_ARCS);
+    for (iarc = 0; iarc < narc; iarc++)
+    {   arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * iarc]);
+        fifosize = ARC_SIZE(S, iarc);
+        wmark = S->arc_watermarks[iarc];
+        sizes[iarc] = fifosize;
+
+        if (0 == RD(wmark, PEAK_WMARK))
+        {   continue;
+        }
+        producer_frame_size = RD(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],PRODUCFMT_ARCW4)], FRAMESIZE_FMT0) + ARC_MSG_OVERHEAD(arc);
+        recommended = RD(wmark, PEAK_WMARK) + producer_frame_size +
+            nanograph_history_bytes(&(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4)]));
+        if (0 != RD(wmark, NEARFULL_WMARK))
+        {   recommended = MAX(recommended, fifosize + producer_frame_size);
+        }
+        sizes[iarc] = (recommended + 3u) & ~3u;
+    }
+}
+#endif
+
+
+#ifdef ARC_AUTO_GROW
+/**
+  @brief         Move an arc often full to a larger buffer
+  @param[in]     instance   global data of the instance
+  @param[in]     iarc       index of the arc
+  @return        base address of the arc buffer, changed when the arc has grown
+
+  @par           Called by the consumer during the data realignment, when the producer is 
+                 blocked (frame boundary). When the arc was found near full ARC_GROW_NEARFULL 
+                 times, a buffer larger by one producer frame is taken from the reserve pool.
+                 The pool is not recycled, the memory of the previous buffer is lost.
+                 The planar arcs are not moved. The arcs of the graph IOs are not moved : a DMA
+                 or an IO driver may still hold the base address of the buffer.
+  @remark
+ */
+
+static uint8_t * arc_auto_grow (nanograph_instance_t *S, uint32_t iarc)
+{
+    uint32_t fifosize, newsize, producer_frame_size, *wmark, *arc, io;
+    uint8_t *base;
+
+    arc = ARC_DESC(S, iarc);
+    wmark = &(S->arc_watermarks[iarc]);
+    if (RD(*wmark, NEARFULL_WMARK) < ARC_GROW_NEARFULL || ARC_IS_PLANAR(arc))
+    {   return ARC_BASE(S, iarc);
+    }
+    for (io = 0; io < S->nb_graph_io; io++)
+    {   if (iarc == RD(S->pio_graph[io * NANOGRAPH_IOFMT_SIZE_W32], IOARCID_IOFMT0))
+        {   return ARC_BASE(S, iarc);
+        }
+    }
+
+    fifosize = ARC_SIZE(S, iarc);
+    producer_frame_size = RD(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],PRODUCFMT_ARCW4)], FRAMESIZE_FMT0) + ARC_MSG_OVERHEAD(arc);
+    newsize = (fifosize + producer_frame_size + 3u) & ~3u;
+    if (newsize > S->arc_pool_free)
+    {   return ARC_BASE(S, iarc);
+    }
+
+    base = S->arc_pool;
+    S->arc_pool = S->arc_pool + newsize;
+    S->arc_pool_free = S->arc_pool_free - newsize;
+
+    ST(arc[BASE_ARCW0], BASEIDXOFFARCW0, lin2pack((intptr_t)base, S->long_offset));
+    ARC_ST_SIZE(S, iarc, newsize)
+    ST(*wmark, NEARFULL_WMARK, 0);
+    return base;
+}
+#endif
+
+
 /**
   @brief         Toolbox of operations on arc
   @param[in]     instance   pointer to the static area of the current nanograph instance
-  @param[in/out] arc        Pointer to the arc descriptor, which can be modified 
+  @param[in]     iarc       index of the arc, the descriptor can be modified 
   @param[in]     tag        Command to execute
   @param[in]     size       parameter used for data moves
   @return        none
 
   @par           "arc_data_operations" implements the data moves to/from arc buffers
-                  and the data realignments
+                  and the data realignments. The realignment keeps the history requested
+                  by the consumer format (HISTORY_FMT0) before the read index.
 
   @remark
  */
 
 static void arc_data_operations (
         nanograph_instance_t *S, 
-        uint32_t *arc, 
+        uint32_t iarc, 
         uint8_t tag, 
         uint8_t *buffer, 
         uintptr_t datasize
@@ -361,12 +561,13 @@ static void arc_data_operations (
     uintptr_t read;
     uintptr_t write;
     uintptr_t size;
-    uintptr_t long_base;
+    uintptr_t history;
+    uint32_t wr_w32, *arc;
     uint8_t *src;
-    uint8_t* dst, *base;
+    uint8_t* dst, *base, *newbase;
 
-    pack2lin(&long_base, arc[BASE_ARCW0], S->long_offset);
-    base = (uint8_t *)long_base;
+    arc = ARC_DESC(S, iarc);
+    base = ARC_BASE(S, iarc);
 
     switch (tag)
     {
@@ -374,27 +575,49 @@ static void arc_data_operations (
     /*   or, buffer is empty but R/W are at the end of the buffer => reset/loop the indexes */ 
 
     case arc_data_realignment_to_base:
-        read = RD(arc[RD_ARCW2], READ_ARCW2);
-        if (read == 0u)
+        read = ARC_READ(S, iarc);
+        history = nanograph_history_bytes(&(S->all_formats[NANOGRAPH_FORMAT_SIZE_W32 * RD(arc[FMT_ARCW4],CONSUMFMT_ARCW4)]));
+        history = MIN(history, read);
+        newbase = base;
+#ifdef ARC_AUTO_GROW
+        newbase = arc_auto_grow(S, iarc);    /* larger buffer taken from the reserve pool */
+#endif
+        if (read == history && newbase == base)
             {
                 break;      /* buffer is full there is nothing to realign */
         }
-        write = RD(arc[WR_ARCW3], WRITE_ARCW3);
-        size = U(write - read);
-        src = base + read;
-        dst =  base;
-        MEMCPY (dst, src, (uint32_t)size);
+        wr_w32 = ARC_WR_LOAD(S, iarc);
+        write = ARC_WRITE_W32(S, iarc, wr_w32);
+        size = U(write - read + history);   /* the tail of consumed data is kept */
+        if (ARC_IS_PLANAR(arc))
+        {   uint32_t nchan, stride, ichan;
+
+            nchan = ARC_NCHAN(S, arc);      /* realignment of each plane */
+            stride = ARC_SIZE(S, iarc) / nchan;
+            for (ichan = 0; ichan < nchan; ichan++)
+            {   src = base + (ichan * stride) + ((read - history) / nchan);
+                dst = base + (ichan * stride);
+                MEMCPY (dst, src, (uint32_t)(size / nchan));
+            }
+        }
+        else
+        {   src = base + read - history;
+            dst =  newbase;
+            MEMCPY (dst, src, (uint32_t)size);
+            S->arc_base[iarc] = (uintptr_t)newbase;
+        }
 
-        /* update the indexes Read=0, Write=dataLength */
-        ST(arc[RD_ARCW2], READ_ARCW2, 0);
-        ST(arc[WR_ARCW3], WRITE_ARCW3, size);
+        /* update the indexes Read=history, Write=dataLength */
+        ARC_ST_READ(S, iarc, history);
+        ARC_ST_WRITE(S, iarc, wr_w32, size)
 
-        /* clear the bit if there is enough free space after this move */
-        set_alignment_bit (S, arc);
+        /* clear the bit if there is enough free space after this move, give the arc back to the producer */
+        wr_w32 = set_alignment_bit (S, iarc, wr_w32);
+        ARC_WR_STORE(S, iarc, wr_w32);
     break;
 
     case data_swapped_with_arc:
-        read = RD(arc[RD_ARCW2], READ_ARCW2);
+        read = ARC_READ(S, iarc);
         src = base + read;
         dst = buffer;
             {
@@ -423,7 +646,8 @@ static void arc_data_operations (
   @param[in]     instance   pointer to the static area of the current naograph instance
   @param[in/out] arc        Pointer to the arc descriptor, which can be modified 
   @param[in]     in0out1    0: the arc is an input of the node, 1: an output of the node
-  @param[in]     xdm_data   pair of pointer + buffer size
+  @param[in]     frame      pairs of pointer + buffer size, followed by the frame time-stamps
+  @param[in]     planar     tables of channel pointers of the planar arcs, MAX_NB_PLANAR_CHANNELS per arc (ARC_PLANAR)
   @return        0 if arcs are not ready for data move => RUN attempt is cancelled
 
   @par           xdm_data isolates the Node computations from the internal data structure
@@ -440,14 +664,18 @@ static void arc_data_operations (
   @remark
  */
 
-static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t *xdm_data, uint8_t pre0post1)
+static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdm_frame_t *frame, intptr_t *planar, uint8_t pre0post1)
 {
-    uint32_t fifosize, read, write;
+    nanograph_xdmbuffer_t *xdm_data = frame->xdm;
+    uint32_t read, write;
     uint32_t *arcpt;
-    uint32_t iarc, arcID;
+    uint32_t iarc, arcID, arcidx;
     uint8_t ret, narc;
     uintptr_t tmp;      // same frame size between input and output arcs "1 to 1 XDM frame size"
 
+#ifndef ARC_PLANAR
+    (void)planar;       /* no planar arc, the channel pointers are not used */
+#endif
     /* all is fine by default */
     ret = 1;        
   
@@ -456,8 +684,9 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
         {
             uint32_t* buffer;
 
-        arcpt =  &(S->all_arcs[SIZEOF_ARCDESC_W32 * (ARC_RX0TX1_CLEAR & (uint32_t)(S->arcID[0]))]);
-        buffer = (uint32_t *)arc_extract_info_pt(S, arcpt, arc_read_address);
+        arcidx = ARC_RX0TX1_CLEAR & (uint32_t)(S->arcID[0]);
+        arcpt = ARC_DESC(S, arcidx);
+        buffer = (uint32_t *)arc_extract_info_pt(S, arcidx, arc_read_address);
         xdm_data[0].address = (intptr_t)S;      xdm_data[0].size = 0;
         xdm_data[1].address = (intptr_t)arcpt;  xdm_data[1].size = 0;
         xdm_data[RD_ARCW2].address = (intptr_t)buffer; xdm_data[2].size = 0;
@@ -482,10 +711,10 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
         uint8_t arc_ready, hqos;
 
         arcID = (S->arcID[iarc]);
-        arcpt = &(S->all_arcs[SIZEOF_ARCDESC_W32 * (ARC_RX0TX1_CLEAR & arcID)]);
-        read = RD(arcpt[RD_ARCW2], READ_ARCW2);
-        write = RD(arcpt[WR_ARCW3], WRITE_ARCW3);
-        fifosize =  RD(arcpt[SIZE_ARCW1], BUFF_SIZE_ARCW1);
+        arcidx = ARC_RX0TX1_CLEAR & arcID;
+        arcpt = ARC_DESC(S, arcidx);
+        read = ARC_READ(S, arcidx);
+        write = ARC_WRITE(S, arcidx);
         hqos = (uint8_t)RD(arcpt[BASE_ARCW0], HIGH_QOS_ARCW0);
 
         {   /* arc control for data compute, time_stamps */
@@ -539,14 +768,14 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
                     {
                         uint32_t* DCache;
 
-                    DCache = &(arcpt[WR_ARCW3]);        /* case "B" */
+                    DCache = &(ARC_WR_W32(S, arcidx));        /* case "B" */
                     INVALIDATE_BUFFER_1LINE(DCache);    /* reload the cache for the Write words of the output arc */
 
-                    DCache = (uint32_t*)arc_extract_info_pt(S, arcpt, arc_read_address);
+                    DCache = (uint32_t*)arc_extract_info_pt(S, arcidx, arc_read_address);
                     INVALIDATE_BUFFER_RANGE(DCache, write-read);    /* reload output buffer */
                 }
 
-                arc_ready = arc_ready_for_write(S, arcpt, (uintptr_t *)&tmp);
+                arc_ready = arc_ready_for_write(S, arcidx, (uintptr_t *)&tmp);
                 if (arc_ready != 0 && hqos != 0)    /* if high QoS arc with data     */
                     {
                         ret = 1;                        /* then force a call to the node */
@@ -557,26 +786,37 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
                         ret = ret & arc_ready;  /* else consolidate decision on all arcs */
                 }
 
-                xdm_data[iarc].address = (intptr_t)(arc_extract_info_pt (S, arcpt, arc_write_address));
-                xdm_data[iarc].size    = arc_extract_info_int (arcpt, arc_free_area);
+                xdm_data[iarc].address = (intptr_t)(arc_extract_info_pt (S, arcidx, arc_write_address));
+                xdm_data[iarc].size    = arc_extract_info_int (S, arcidx, arc_free_area);
+#ifdef ARC_PLANAR
+                if (ARC_IS_PLANAR(arcpt))
+                {   arc_planar_pointers(S, arcidx, write, &(planar[iarc * MAX_NB_PLANAR_CHANNELS]));
+                    xdm_data[iarc].address = (intptr_t)&(planar[iarc * MAX_NB_PLANAR_CHANNELS]);
+                }
+#endif
             }
             else 
             {   /* the NODE put the amount of data produced in "size"
                         output buffer of the NODE : update the arc index */
+                uint32_t wr_w32;
+
                 write = write + (uint32_t)(xdm_data[iarc].size);
-                ST(arcpt[WR_ARCW3], WRITE_ARCW3, write);
+                wr_w32 = ARC_WR_LOAD(S, arcidx);
+                ARC_ST_WRITE(S, arcidx, wr_w32, write)
 
                 /* set ALIGNBLCK_ARCW3 if (fifosize - write < producer_frame_size) */
-                set_alignment_bit (S, arcpt);
+                wr_w32 = set_alignment_bit (S, arcidx, wr_w32);
+                ARC_WR_STORE(S, arcidx, wr_w32);     /* publish the data produced by the node */
+                ARC_WATERMARK(S, arcidx, write - read, TEST_BIT(wr_w32, ALIGNBLCK_ARCW3_LSB));
 
                 /* invalidate/reload the cache for buffers used with DMA and multiprocessing */
                 if (MPFLUSH_CTRL0 == RD(arcpt[BASE_ARCW0], MPFLUSH_ARCW0))
                     {
                         uint32_t* DCache;
-                    DCache = &(arcpt[WR_ARCW3]);    /* case "C" */
+                    DCache = &(ARC_WR_W32(S, arcidx));    /* case "C" */
                     // CLEAN_BUFFER_1LINE(DCache);     /* flush the cache for the Write words of the output arc */
 
-                    DCache = (uint32_t*)arc_extract_info_pt(S, arcpt, arc_read_address);
+                    DCache = (uint32_t*)arc_extract_info_pt(S, arcidx, arc_read_address);
                     // CLEAN_BUFFER_RANGE(DCache, write - read);   /* flush output buffer */
                 }
             }
@@ -589,17 +829,17 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
                 if (MPFLUSH_CTRL0 == RD(arcpt[BASE_ARCW0], MPFLUSH_ARCW0))
                     {
                         uint32_t* DCache;
-                    DCache = &(arcpt[RD_ARCW2]);      /* case "A" 1 */
+                    DCache = &(ARC_RD_W32(S, arcidx));      /* case "A" 1 */
                     //INVALIDATE_BUFFER_1LINE(DCache);
 
-                    DCache = &(arcpt[WR_ARCW3]);      /* case "A" 2 */
+                    DCache = &(ARC_WR_W32(S, arcidx));      /* case "A" 2 */
                     //INVALIDATE_BUFFER_1LINE(DCache);  /* reload the cache */
 
-                    DCache = (uint32_t*)arc_extract_info_pt(S, arcpt, arc_read_address); /* case "A" 3 */
+                    DCache = (uint32_t*)arc_extract_info_pt(S, arcidx, arc_read_address); /* case "A" 3 */
                     //INVALIDATE_BUFFER_RANGE(DCache, write - read);
                 }
 
-                arc_ready = arc_ready_for_read(S, arcpt, (uintptr_t *)&tmp);
+                arc_ready = arc_ready_for_read(S, arcidx, (uintptr_t *)&tmp);
                 if (arc_ready != 0 && hqos != 0)    /* if high QoS arc with data     */
                     {
                         ret = 1;                        /* then force a call to the node */
@@ -614,21 +854,34 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
                     then it is the responsibility of the consumer node (current SWC) to realign the
                     data, and clear the flag.
                 */
-                if (TEST_BIT(arcpt[WR_ARCW3], ALIGNBLCK_ARCW3_LSB))
+                if (TEST_BIT(ARC_WR_LOAD(S, arcidx), ALIGNBLCK_ARCW3_LSB))
                     {
-                        arc_data_operations(S, arcpt, arc_data_realignment_to_base, 0, 0);
+                        arc_data_operations(S, arcidx, arc_data_realignment_to_base, 0, 0);
                 }
 
-                xdm_data[iarc].address = (intptr_t)(arc_extract_info_pt(S, arcpt, arc_read_address));
-                xdm_data[iarc].size = arc_extract_info_int(arcpt, arc_data_amount);
+                xdm_data[iarc].address = (intptr_t)(arc_extract_info_pt(S, arcidx, arc_read_address));
+                xdm_data[iarc].size = arc_extract_info_int(S, arcidx, arc_data_amount);
+#ifdef ARC_PLANAR
+                if (ARC_IS_PLANAR(arcpt))
+                {   read = ARC_READ(S, arcidx);    /* the consumer may have realigned */
+                    arc_planar_pointers(S, arcidx, read, &(planar[iarc * MAX_NB_PLANAR_CHANNELS]));
+                    xdm_data[iarc].address = (intptr_t)&(planar[iarc * MAX_NB_PLANAR_CHANNELS]);
+                }
+#endif
+                #ifdef ARC_TIMESTAMPS
+                frame->time_stamp[iarc] = 0;
+                frame->time_offset[iarc] = 0;
+                if (NO_TIMESTAMP != ARC_TSTP_TYPE(S, arcpt))
+                {   frame->time_stamp[iarc] = arc_time_stamp_lookup(S, arcidx, &(frame->time_offset[iarc]));
+                }
+                #endif
             }
             else 
             {   /* postprocessing : flush the R and W index */
-                uint32_t producer_frame_size, fmt;
                 if (0 != RD(arcpt[BASE_ARCW0], MPFLUSH_ARCW0))
                     {
                         uint32_t* DCache;
-                    DCache = &(arcpt[WR_ARCW3]);
+                    DCache = &(ARC_WR_W32(S, arcidx));
                     // CLEAN_BUFFER_1LINE(DCache);
                     //DATA_MEMORY_BARRIER
                 }
@@ -637,14 +890,17 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
                 /* the NODE put the amount of data consumed in "size"
                         input buffer of the SWC, update the read index*/
                 read = read + (uint32_t)(xdm_data[iarc].size);
-                ST(arcpt[RD_ARCW2], READ_ARCW2, read);
-
-                /* does data realignement must be done ? : realign and clear the bit */
-                fmt = RD(arcpt[FMT_ARCW4],PRODUCFMT_ARCW4) * NANOGRAPH_FORMAT_SIZE_W32;
-                producer_frame_size = RD(S->all_formats[fmt], FRAMESIZE_FMT0);
-                if (write > U(fifosize - producer_frame_size))
+                ARC_ST_READ(S, arcidx, read);        /* release the data consumed by the node */
+                #ifdef ARC_TIMESTAMPS
+                S->arc_time_stamps[SIZEOF_ARCTSTP_W32 * arcidx + RDPOS_ARCTSTP] += (uint32_t)(xdm_data[iarc].size);
+                #endif
+
+                /* does data realignement must be done ? : realign and clear the bit.
+                    The write index belongs to the producer (node or IO interrupt) until it sets 
+                    ALIGNBLCK_ARCW3 and stops writing, the consumer only moves the data after it. */
+                if (TEST_BIT(ARC_WR_LOAD(S, arcidx), ALIGNBLCK_ARCW3_LSB))
                     {
-                        arc_data_operations(S, arcpt, arc_data_realignment_to_base, 0, 0);
+                        arc_data_operations(S, arcidx, arc_data_realignment_to_base, 0, 0);
                 }
 
                 /* flush the cache and the memory barriers for buffers used with DMA and multiprocessing */
@@ -652,7 +908,7 @@ static uint8_t arc_index_update (nanograph_instance_t *S, nanograph_xdmbuffer_t
                     {
                         uint32_t* DCache;
                     /* flush input  arcs R */
-                    DCache = &(arcpt[RD_ARCW2]);
+                    DCache = &(ARC_RD_W32(S, arcidx));
                     // CLEAN_BUFFER_1LINE(DCache);         /* case "D" */
 
                     //DATA_MEMORY_BARRIER
@@ -713,13 +969,11 @@ void load_clear_memory_segments (nanograph_instance_t *S, uint8_t pre0post1)
         if (TEST_BIT(memReqWord2, SWAP_LW2S0_LSB))
             {
                 uint16_t arcID;
-            uint32_t *arc;
 
             arcID = RD(memReqWord2, SWAPBUFID_LW2S);
-            arc = &(S->all_arcs[SIZEOF_ARCDESC_W32 * (ARC_RX0TX1_CLEAR & arcID)]);
-            memlen = RD(arc[SIZE_ARCW1], BUFF_SIZE_ARCW1);
+            memlen = ARC_SIZE(S, ARC_RX0TX1_CLEAR & arcID);
 
-            arc_data_operations (S, arc, data_swapped_with_arc, lw2s, memlen);
+            arc_data_operations (S, ARC_RX0TX1_CLEAR & arcID, data_swapped_with_arc, lw2s, memlen);
         }
 
         /* clear memory if (static and reset) | working */
@@ -766,8 +1020,7 @@ static void check_graph_boundaries(nanograph_instance_t *S)
     //uint32_t offset_to_nanograph_io;
     uint8_t *buffer;
     uint8_t ongoing_mask, ongoing_idx;
-    uint8_t arc_idx;
-    uint32_t *arcpt;
+    uint32_t arc_idx;
     uint32_t *pio_control;
     uint32_t read_hwio_control;
     const p_io_function_ctrl *io_func;
@@ -795,14 +1048,25 @@ static void check_graph_boundaries(nanograph_instance_t *S)
         /* is it a servant/asynchronous IO ? 
                ?commander? when it initiates data exchanges with the graph without control from the scheduler, for example an audio codec.
                ?servant? when the scheduler must asynchronously pull or push data by calling abstraction */
+        arc_idx = ARC_RX0TX1_CLEAR & RD(*pio_control, IOARCID_IOFMT0);
+
+#ifdef IO_COALESCING
+        /* staged RX data of an IO without new acknowledge, published when its timeout is passed */
+        if (RX0_TO_GRAPH == TEST_BIT(*pio_control, RX0TX1_IOFMT0_LSB))
+        {   io_coalesce_timeout(S, graph_io_idx, arc_idx);
+        }
+#endif
+
         if (IO_IS_COMMANDER0 == TEST_BIT(*pio_control, SERVANT1_IOFMT0_LSB))
             {
+                /* back-pressure of the commander IO from the arc occupancy, single writer of io_flow_state[] */
+                if (RX0_TO_GRAPH == TEST_BIT(*pio_control, RX0TX1_IOFMT0_LSB))
+                {   io_flow_control_update(S, graph_io_idx, arc_idx, 
+                        (uint32_t)arc_extract_info_int(S, arc_idx, arc_data_amount));
+                }
                 continue;
         }
 
-        arc_idx = (uint8_t)(ARC_RX0TX1_CLEAR & RD(*pio_control, IOARCID_IOFMT0));
-        arcpt = &(S->all_arcs[SIZEOF_ARCDESC_W32 * arc_idx]);
-
         /* a previous request is in process then no need to ask again */
         ongoing_idx = graph_io_idx / 8;
         ongoing_mask = 1 << (graph_io_idx - ongoing_idx * 8);
@@ -822,8 +1086,8 @@ static void check_graph_boundaries(nanograph_instance_t *S)
         if (RX0_TO_GRAPH == TEST_BIT(*pio_control, RX0TX1_IOFMT0_LSB))
         {   
             /* (size = FIFO size - write index) >= producer 1 frame size  */
-            need_data_move = arc_ready_for_write(S, arcpt, &size);
-            buffer = arc_extract_info_pt(S, arcpt, arc_write_address);
+            need_data_move = arc_ready_for_write(S, arc_idx, &size);
+            buffer = arc_extract_info_pt(S, arc_idx, arc_write_address);
             if (size == 0u) /* size free for writes = 0 ? */
                 {
                     continue;   /* look next IO */
@@ -833,8 +1097,8 @@ static void check_graph_boundaries(nanograph_instance_t *S)
         /* if this is an output stream : check the buffer has data (size = W-R) >= 1 consumer frame size */
         else
             {
-                need_data_move = arc_ready_for_read(S, arcpt, &size);
-            buffer = arc_extract_info_pt(S, arcpt, arc_read_address);
+                need_data_move = arc_ready_for_read(S, arc_idx, &size);
+            buffer = arc_extract_info_pt(S, arc_idx, arc_read_address);
             if (size == 0u)     /* size free for read = 0 ? */
                 {
                     continue;       /* look next IO */
@@ -860,6 +1124,16 @@ static void check_graph_boundaries(nanograph_instance_t *S)
                 size = ready for data / free for write */
             pt_pt.address = (intptr_t)buffer;
             pt_pt.size = (intptr_t)size;
+            #ifdef IO_RECORD
+            {   nanograph_io_segment_t request;
+                request.data = buffer;
+                request.size = size;
+                IO_RECORD_EVENT(IO_EVENT_REQUEST, (uint8_t)RD(*pio_control, FWIOIDX_IOFMT0), &request, 1);
+            }
+            #endif
+            #ifdef IO_REPLAY
+            continue;       /* the acknowledges come from the recorded events, see io_replay_feed() */
+            #endif
             (*io_func)(NANOGRAPH_RUN, &pt_pt);
         }
     }
@@ -950,6 +1224,11 @@ void nanograph_interpreter_process (nanograph_instance_t *S, int8_t command, uin
     /* loop until all the components are blocked by the data streams */
 	do 
     {
+#ifdef IO_ACK_QUEUE
+        /* data moves of the IO interrupts, posted with NanoGraph_io_ack_post() */
+        io_ack_drain(S);
+#endif
+
         /* start scanning the list assuming no data is processed */
         CLEAR_BIT(S->scheduler_control, STILDATA_SCTRL_LSB);
 
@@ -1074,8 +1353,13 @@ static uint8_t read_header (nanograph_instance_t *S)
             {
                 TX_found = 1;
                 /* the base arc holds the byte pointer for locking the node */
+#ifdef ARC_HOT_COLD_SPLIT
+                x = RD_HOTW1 + SIZEOF_ARCHOT_W32 * (ARC_RX0TX1_CLEAR & S->arcID[iarc]);
+                S->pt8b_collision_arc = (uint8_t *)&(S->arc_hot[x]);
+#else
                 x = SIZE_ARCW1 + SIZEOF_ARCDESC_W32 * (ARC_RX0TX1_CLEAR & S->arcID[iarc]);
                 S->pt8b_collision_arc = (uint8_t *)&(S->all_arcs[x]); /* point to the LSB of the 3rd word of arc descriptor */
+#endif
                 S->pt8b_collision_arc = &(S->pt8b_collision_arc[COLLISION_ARCW2_BYTE]); /* now the MSB */
             }
         }
@@ -1085,8 +1369,13 @@ static uint8_t read_header (nanograph_instance_t *S)
             {
                 TX_found = 1;
                 /* the base arc holds the byte pointer for locking the node */
+#ifdef ARC_HOT_COLD_SPLIT
+                x = RD_HOTW1 + SIZEOF_ARCHOT_W32 * (ARC_RX0TX1_CLEAR & S->arcID[iarc +1]);
+                S->pt8b_collision_arc = (uint8_t *)&(S->arc_hot[x]);
+#else
                 x = SIZE_ARCW1 + SIZEOF_ARCDESC_W32 * (ARC_RX0TX1_CLEAR & S->arcID[iarc +1]);
                 S->pt8b_collision_arc = (uint8_t *)&(S->all_arcs[x]);
+#endif
                 S->pt8b_collision_arc = &(S->pt8b_collision_arc[COLLISION_ARCW2_BYTE]);
             }
         }
@@ -1513,7 +1802,12 @@ static void set_reset_parameters (nanograph_instance_t *S, uint32_t *ptr_param32
 
 static void run_node (nanograph_instance_t *S)
 {
-    nanograph_xdmbuffer_t xdm_data[MAX_NB_NANOGRAPH_PER_NODE];
+    nanograph_xdm_frame_t frame;
+#ifdef ARC_PLANAR
+    intptr_t planar[MAX_NB_NANOGRAPH_PER_NODE * MAX_NB_PLANAR_CHANNELS];
+#else
+    intptr_t *planar = 0;
+#endif
     uint32_t check;
     uint8_t loop_counter, *pt8, script;
 
@@ -1526,7 +1820,7 @@ static void run_node (nanograph_instance_t *S)
     }
 
     /* push all the ARCs on the stack/xdm_buffer and check arcs buffer are ready */
-    if (0u == arc_index_update(S, xdm_data, 0))
+    if (0u == arc_index_update(S, &frame, planar, 0))
         {
             return; /* buffers are not ready */
     }
@@ -1558,14 +1852,14 @@ static void run_node (nanograph_instance_t *S)
            to give some CPU periods for trigering data moves 
            long NODE can be split to allow data moves without RTOS */
         nanograph_calls_node (S,
-            S->node_instance_addr, xdm_data,  &check);
+            S->node_instance_addr, frame.xdm,  &check);
         } while ((check == NODE_TASKS_NOT_COMPLETED) && ((--loop_counter) > 0));
     
     /*  output FIFO write pointer is incremented AND a check is made for data 
         re-alignment to base adresses (to avoid address looping)
         The NODE don't wait and let the consumer manage the alignement 
     */
-    arc_index_update(S, xdm_data, 1); 
+    arc_index_update(S, &frame, planar, 1); 
 
     script_processing(script, SCRIPT_POSTRUN);
 
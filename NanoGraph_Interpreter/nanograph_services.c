@@ -37,36 +37,380 @@
 #include "../nanograph_interpreter.h"
 
 
-//void generic_biquad_cascade_df1_init_q15(
-//    generic_biquad_cascade_df1_inst_q15* S,
-//    uint8_t numStages,
-//    const int16_t* pCoeffs,
-//    int16_t* pState,
-//    int8_t postShift)
-//{
-//}
-//void generic_biquad_cascade_df1_fast_q15(
-//    const generic_biquad_cascade_df1_inst_q15* S,
-//    const int16_t* pSrc,
-//    int16_t* pDst,
-//    uint32_t blockSize)
-//{
-//}
+/* ------------------------------------------------------------------------------------------------------------
+    DF1 Q15 biquad cascade, bit-exact with CMSIS-DSP arm_biquad_cascade_df1_fast_q15
+        coefficients {b0, 0, b1, b2, a1, a2} per stage, state {x[n-1], x[n-2], y[n-1], y[n-2]} per stage
+        32-bit wrapping accumulator (SMLAD), shifted by 15-postShift and saturated to 16 bits
+
+    The stages are computed in the lanes of a vector (GCC/Clang vector extensions, SSE4.1/AVX2/Neon
+    when enabled) : at step t the lane k computes the sample t-k of the stage k from the output of 
+    the lane k-1 at step t-1. The lanes of the pipeline start and end are masked.
+ */
+#if defined(__AVX2__)
+#define DF1_Q15_LANES 8                             /* 256 bits registers */
+#define DF1_Q15_LANE_SHIFT 0, 0, 1, 2, 3, 4, 5, 6
+#else
+#define DF1_Q15_LANES 4                             /* 128 bits registers */
+#define DF1_Q15_LANE_SHIFT 0, 0, 1, 2
+#endif
+#define DF1_Q15_MAX 32767
+#define DF1_Q15_MIN (-32768)
+
+#if defined(__GNUC__)
+typedef int32_t  df1_q15_vs __attribute__((vector_size(4 * DF1_Q15_LANES)));
+typedef uint32_t df1_q15_vu __attribute__((vector_size(4 * DF1_Q15_LANES)));
+
+#if defined(__clang__)
+#define DF1_Q15_NEXT_LANE(v) __builtin_shufflevector((v), (v), DF1_Q15_LANE_SHIFT)
+#else
+#define DF1_Q15_NEXT_LANE(v) __builtin_shuffle((v), (df1_q15_vs){DF1_Q15_LANE_SHIFT})
+#endif
+#define DF1_Q15_SELECT(m,a,b) (((a) & (m)) | ((b) & ~(m)))
+#endif
+
+
+/**
+  @brief        Initialization of the Q15 DF1 biquad cascade
+  @param[out]   S           filter instance
+  @param[in]    numStages   number of second order stages
+  @param[in]    pCoeffs     coefficients {b0, 0, b1, b2, a1, a2} per stage
+  @param[in]    pState      state of 4 samples per stage, cleared
+  @param[in]    postShift   shift of the accumulator, coefficients in q(15-postShift)
+  @return       none
+ */
+void generic_biquad_cascade_df1_init_q15(
+    generic_biquad_cascade_df1_inst_q15* S,
+    uint8_t numStages,
+    const int16_t* pCoeffs,
+    int16_t* pState,
+    int8_t postShift)
+{
+    S->numStages = (int8_t)numStages;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    S->postShift = postShift;
+    MEMSET(pState, 0, 4u * numStages * sizeof(int16_t));
+}
+
+
+/**
+  @brief        One stage of the Q15 DF1 biquad cascade, one sample at a time
+  @param[in]    coefs       {b0, 0, b1, b2, a1, a2}
+  @param[in]    state       {x[n-1], x[n-2], y[n-1], y[n-2]}
+  @param[in]    src         input samples
+  @param[out]   dst         output samples, can be src
+  @param[in]    n           number of samples
+  @param[in]    shift       15-postShift
+  @return       none
+ */
+static void df1_fast_q15_stage (const int16_t *coefs, int16_t *state, const int16_t *src, int16_t *dst, uint32_t n, int32_t shift)
+{
+    int32_t x, x1, x2, y, y1, y2;
+    uint32_t i, acc;
+
+    x1 = state[0];  x2 = state[1];
+    y1 = state[2];  y2 = state[3];
+
+    for (i = 0; i < n; i++)
+    {   x = src[i];
+        acc = (uint32_t)(coefs[0] * x)  + (uint32_t)(coefs[2] * x1) + (uint32_t)(coefs[3] * x2)
+            + (uint32_t)(coefs[4] * y1) + (uint32_t)(coefs[5] * y2);
+        y = (int32_t)acc >> shift;
+        y = MIN(DF1_Q15_MAX, MAX(DF1_Q15_MIN, y));
+        dst[i] = (int16_t)y;
+        x2 = x1;    x1 = x;
+        y2 = y1;    y1 = y;
+    }
+
+    state[0] = (int16_t)x1; state[1] = (int16_t)x2;
+    state[2] = (int16_t)y1; state[3] = (int16_t)y2;
+}
+
+
+#if defined(__GNUC__)
+/**
+  @brief        Up to DF1_Q15_LANES stages of the Q15 DF1 biquad cascade, one stage per lane
+  @param[in]    coefs       {b0, 0, b1, b2, a1, a2} of each stage
+  @param[in]    state       {x[n-1], x[n-2], y[n-1], y[n-2]} of each stage
+  @param[in]    nstages     number of stages
+  @param[in]    src         input samples
+  @param[out]   dst         output samples, can be src
+  @param[in]    n           number of samples
+  @param[in]    shift       15-postShift
+  @return       none
+
+  @par          The output of the step t is the sample t+1-nstages, written after the input sample t
+                is read, in-place processing is possible.
+ */
+static void df1_fast_q15_lanes (const int16_t *coefs, int16_t *state, uint32_t nstages, const int16_t *src, int16_t *dst, uint32_t n, int32_t shift)
+{
+    df1_q15_vs b0, b1, b2, a1, a2, x, x1, x2, y, y1, y2, lane, idx, valid, m;
+    df1_q15_vu acc;
+    uint32_t k, t;
+
+    b0 = b1 = b2 = a1 = a2 = x1 = x2 = y1 = y2 = y = lane = (df1_q15_vs){0};
+    for (k = 0; k < DF1_Q15_LANES; k++)
+    {   lane[k] = (int32_t)k;
+    }
+    for (k = 0; k < nstages; k++)
+    {   b0[k] = coefs[6*k + 0];     b1[k] = coefs[6*k + 2];     b2[k] = coefs[6*k + 3];
+        a1[k] = coefs[6*k + 4];     a2[k] = coefs[6*k + 5];
+        x1[k] = state[4*k + 0];     x2[k] = state[4*k + 1];
+        y1[k] = state[4*k + 2];     y2[k] = state[4*k + 3];
+    }
+
+    for (t = 0; t < n + nstages - 1; t++)
+    {   
+        x = DF1_Q15_NEXT_LANE(y);
+        x[0] = (t < n) ? src[t] : 0;
+
+        acc = (df1_q15_vu)(b0 * x) + (df1_q15_vu)(b1 * x1) + (df1_q15_vu)(b2 * x2)
+            + (df1_q15_vu)(a1 * y1) + (df1_q15_vu)(a2 * y2);
+        y = (df1_q15_vs)acc >> shift;
+        m = y > DF1_Q15_MAX;    y = DF1_Q15_SELECT(m, (df1_q15_vs){0} + DF1_Q15_MAX, y);
+        m = y < DF1_Q15_MIN;    y = DF1_Q15_SELECT(m, (df1_q15_vs){0} + DF1_Q15_MIN, y);
+
+        /* the lane k holds the sample t-k of its stage */
+        idx = (int32_t)t - lane;
+        valid = (idx >= 0) & (idx < (int32_t)n) & (lane < (int32_t)nstages);
+        x2 = DF1_Q15_SELECT(valid, x1, x2);
+        x1 = DF1_Q15_SELECT(valid, x, x1);
+        y2 = DF1_Q15_SELECT(valid, y1, y2);
+        y1 = DF1_Q15_SELECT(valid, y, y1);
+
+        if (t + 1 >= nstages)
+        {   dst[t + 1 - nstages] = (int16_t)y[nstages - 1];
+        }
+    }
+
+    for (k = 0; k < nstages; k++)
+    {   state[4*k + 0] = (int16_t)x1[k];    state[4*k + 1] = (int16_t)x2[k];
+        state[4*k + 2] = (int16_t)y1[k];    state[4*k + 3] = (int16_t)y2[k];
+    }
+}
+#endif
+
+
+/**
+  @brief        Q15 DF1 biquad cascade, bit-exact with arm_biquad_cascade_df1_fast_q15
+  @param[in]    S           filter instance
+  @param[in]    pSrc        input samples
+  @param[out]   pDst        output samples, can be pSrc
+  @param[in]    blockSize   number of samples
+  @return       none
+
+  @par          The stages are processed by groups of DF1_Q15_LANES in the lanes of a vector, 
+                a single stage (or a compiler without vector extensions) is processed sample 
+                by sample.
+ */
+void generic_biquad_cascade_df1_fast_q15(
+    const generic_biquad_cascade_df1_inst_q15* S,
+    const int16_t* pSrc,
+    int16_t* pDst,
+    uint32_t blockSize)
+{
+    const int16_t *coefs = S->pCoeffs;
+    int16_t *state = S->pState;
+    int32_t shift = 15 - S->postShift;
+    uint32_t stage, nstages, nlanes;
+
+    nstages = (uint8_t)(S->numStages);
+    for (stage = 0; stage < nstages; stage += nlanes)
+    {   
+        nlanes = MIN(DF1_Q15_LANES, nstages - stage);
+#if defined(__GNUC__)
+        if (nlanes > 1)
+        {   df1_fast_q15_lanes(&(coefs[6 * stage]), &(state[4 * stage]), nlanes, pSrc, pDst, blockSize, shift);
+        }
+        else
+#endif
+        {   df1_fast_q15_stage(&(coefs[6 * stage]), &(state[4 * stage]), pSrc, pDst, blockSize, shift);
+        }
+        pSrc = pDst;                                /* the next stages are in-place */
+    }
+}
+
+
+/* ------------------------------------------------------------------------------------------------------------
+    Float biquad cascades DF1 and DF2T (transposed direct form 2), multichannel
+        coefficients {b0, b1, b2, a1, a2} per stage shared by the channels, a1 a2 negated as in CMSIS-DSP
+        state [stage][4 DF1 or 2 DF2T][channel], the samples of the channels are interleaved
+
+    The channels are computed in the lanes of a vector by groups of 4 (GCC/Clang vector extensions :
+    SSE/Neon on the host, Helium on Cortex-M55/M85) or 8 (AVX), the other channels one at a time.
+ */
+#define BIQ_F32_DF1 4                               /* state words per stage and channel */
+#define BIQ_F32_DF2T 2
+
+#if defined(__GNUC__)
+typedef float biq_f32_v4  __attribute__((vector_size(16)));             /* 128 bits registers */
+typedef float biq_f32_v4u __attribute__((vector_size(16), aligned(4))); /* unaligned accesses */
+#define BIQ_F32_LDV4(p)   (*(const biq_f32_v4u *)(p))
+#define BIQ_F32_STV4(p,v) (*(biq_f32_v4u *)(p) = (v))
+#if defined(__AVX__)
+typedef float biq_f32_v8  __attribute__((vector_size(32)));             /* 256 bits registers */
+typedef float biq_f32_v8u __attribute__((vector_size(32), aligned(4)));
+#define BIQ_F32_LDV8(p)   (*(const biq_f32_v8u *)(p))
+#define BIQ_F32_STV8(p,v) (*(biq_f32_v8u *)(p) = (v))
+#endif
+#endif
+#define BIQ_F32_LD1(p)   (*(p))
+#define BIQ_F32_ST1(p,v) (*(p) = (v))
+
+/* one stage of "n" samples, one channel (T = float) or the channels of the lanes of T */
+#define BIQ_F32_DF1_STAGE(T, LD, ST)                                                \
+    {   T x, y, x1, x2, y1, y2;                                                     \
+        x1 = LD(&st[0]);        x2 = LD(&st[nch]);                                  \
+        y1 = LD(&st[2*nch]);    y2 = LD(&st[3*nch]);                                \
+        for (i = 0; i < n; i++)                                                     \
+        {   x = LD(&in[i*nch]);                                                     \
+            y = b0 * x + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;                     \
+            ST(&out[i*nch], y);                                                     \
+            x2 = x1;    x1 = x;                                                     \
+            y2 = y1;    y1 = y;                                                     \
+        }                                                                           \
+        ST(&st[0], x1);         ST(&st[nch], x2);                                   \
+        ST(&st[2*nch], y1);     ST(&st[3*nch], y2);                                 \
+    }
+
+#define BIQ_F32_DF2T_STAGE(T, LD, ST)                                               \
+    {   T x, y, d1, d2;                                                             \
+        d1 = LD(&st[0]);        d2 = LD(&st[nch]);                                  \
+        for (i = 0; i < n; i++)                                                     \
+        {   x = LD(&in[i*nch]);                                                     \
+            y = b0 * x + d1;                                                        \
+            d1 = b1 * x + a1 * y + d2;                                              \
+            d2 = b2 * x + a2 * y;                                                   \
+            ST(&out[i*nch], y);                                                     \
+        }                                                                           \
+        ST(&st[0], d1);         ST(&st[nch], d2);                                   \
+    }
+
+
+/**
+  @brief        Float biquad cascade, DF1 or DF2T
+  @param[in]    S           filter instance
+  @param[in]    src         interleaved input samples
+  @param[out]   dst         interleaved output samples, can be src
+  @param[in]    n           number of samples per channel
+  @param[in]    form        BIQ_F32_DF1 or BIQ_F32_DF2T
+  @return       none
+ */
+static void biquad_f32_run (const generic_biquad_cascade_df1_inst_f32 *S, const float *src, float *dst, uint32_t n, uint32_t form)
+{
+    const float *in, *c;
+    float *out, *st;
+    float b0, b1, b2, a1, a2;
+    uint32_t i, ch, nch, stage, nlanes;
+
+    nch = S->numChannels;
+    for (ch = 0; ch < nch; ch += nlanes)
+    {   
+        nlanes = 1;
+#if defined(__GNUC__)
+        if (nch - ch >= 4)
+        {   nlanes = 4;
+        }
+#if defined(__AVX__)
+        if (nch - ch >= 8)
+        {   nlanes = 8;
+        }
+#endif
+#endif
+        in = &(src[ch]);
+        out = &(dst[ch]);
+
+        for (stage = 0; stage < S->numStages; stage++)
+        {   c = &(S->pCoeffs[5 * stage]);
+            b0 = c[0];  b1 = c[1];  b2 = c[2];  a1 = c[3];  a2 = c[4];
+            st = &(S->pState[form * nch * stage + ch]);
+
+            switch (nlanes)
+            {
+#if defined(__GNUC__)
+#if defined(__AVX__)
+            case 8:
+                if (form == BIQ_F32_DF1)
+                    BIQ_F32_DF1_STAGE(biq_f32_v8, BIQ_F32_LDV8, BIQ_F32_STV8)
+                else
+                    BIQ_F32_DF2T_STAGE(biq_f32_v8, BIQ_F32_LDV8, BIQ_F32_STV8)
+                break;
+#endif
+            case 4:
+                if (form == BIQ_F32_DF1)
+                    BIQ_F32_DF1_STAGE(biq_f32_v4, BIQ_F32_LDV4, BIQ_F32_STV4)
+                else
+                    BIQ_F32_DF2T_STAGE(biq_f32_v4, BIQ_F32_LDV4, BIQ_F32_STV4)
+                break;
+#endif
+            default:
+                if (form == BIQ_F32_DF1)
+                    BIQ_F32_DF1_STAGE(float, BIQ_F32_LD1, BIQ_F32_ST1)
+                else
+                    BIQ_F32_DF2T_STAGE(float, BIQ_F32_LD1, BIQ_F32_ST1)
+                break;
+            }
+            in = out;                               /* the next stages are in-place */
+        }
+    }
+}
+
+
+/**
+  @brief        Initialization of the float biquad cascades
+  @param[out]   S           filter instance
+  @param[in]    numStages   number of second order stages
+  @param[in]    numChannels number of interleaved channels
+  @param[in]    pCoeffs     coefficients {b0, b1, b2, a1, a2} per stage
+  @param[in]    pState      state of 4 (DF1) or 2 (DF2T) words per stage and channel, cleared
+  @return       none
+ */
+void generic_biquad_cascade_df1_init_f32(
+    generic_biquad_cascade_df1_inst_f32* S,
+    uint8_t numStages,
+    uint8_t numChannels,
+    const float* pCoeffs,
+    float* pState)
+{
+    S->numStages = numStages;
+    S->numChannels = numChannels;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    MEMSET(pState, 0, BIQ_F32_DF1 * numStages * numChannels * sizeof(float));
+}
+
+void generic_biquad_cascade_df2T_init_f32(
+    generic_biquad_cascade_df1_inst_f32* S,
+    uint8_t numStages,
+    uint8_t numChannels,
+    const float* pCoeffs,
+    float* pState)
+{
+    S->numStages = numStages;
+    S->numChannels = numChannels;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    MEMSET(pState, 0, BIQ_F32_DF2T * numStages * numChannels * sizeof(float));
+}
+
+void generic_biquad_cascade_df1_f32(
+    const generic_biquad_cascade_df1_inst_f32* S,
+    const float* pSrc,
+    float* pDst,
+    uint32_t blockSize)
+{
+    biquad_f32_run(S, pSrc, pDst, blockSize, BIQ_F32_DF1);
+}
+
+void generic_biquad_cascade_df2T_f32(
+    const generic_biquad_cascade_df1_inst_f32* S,
+    const float* pSrc,
+    float* pDst,
+    uint32_t blockSize)
+{
+    biquad_f32_run(S, pSrc, pDst, blockSize, BIQ_F32_DF2T);
+}
 
-//void generic_biquad_cascade_df1_init_f32(
-//    biquad_cascade_df1_inst_f32* S,
-//    uint8_t numStages,
-//    const float* pCoeffs,
-//    float* pState)
-//{
-//}
-//void generic_biquad_cascade_df1_fast_f32(
-//    generic_biquad_cascade_df1_inst_f32* S,
-//    const float* pSrc,
-//    float* pDst,
-//    uint32_t blockSize)
-//{
-//}
 
 /* ------------------------------------------------------------------------------------------------------------
   @brief        Size of raw data
@@ -95,6 +439,25 @@ int32_t nanograph_bitsize_of_raw(uint8_t raw)
 }
 
 
+/* ------------------------------------------------------------------------------------------------------------
+  @brief        Size of the history kept before the read index of an arc
+  @param[in]    format     stream format of the consumer (words FMT0 and FMT1)
+  @return       size in bytes
+
+  @remark       HISTORY_FMT0 samples of all the channels
+ */
+
+uint32_t nanograph_history_bytes(uint32_t *format)
+{
+    uint32_t nsamp, nchan, nbits;
+
+    nsamp = RD(format[FRAMESZ_FMT0], HISTORY_FMT0);
+    nchan = RD(format[NCHANDOMAIN_FMT1], NCHANM1_FMT1) + 1;
+    nbits = (uint32_t)nanograph_bitsize_of_raw((uint8_t)RD(format[NCHANDOMAIN_FMT1], RAW_FMT1));
+    return (nsamp * nchan * nbits) / 8;
+}
+
+
 /* ------------------------------------------------------------------------------------------------------------
   @brief        ITOAB integer to ASCII with Base (binary, octal, decimal, hexadecimal)
   @param[in]    integer
@@ -514,61 +877,82 @@ void nanograph_services (uint32_t command, intptr_t ptr1, intptr_t ptr2, intptr_
                         extern df1_q15_init generic_biquad_cascade_df1_init_q15;
                         generic_biquad_cascade_df1_init_q15(                // void arm_biquad_cascade_df1_init_q15(
                             (generic_biquad_cascade_df1_inst_q15 *) ptr1,   //         biquad_cascade_df1_inst_q15 * S,
-                            n & 0xFF,                                       //         uint8_t numStages,
+                            (uint8_t)(n >> 8),                              //         uint8_t numStages,
                             (const int16_t *) ptr2,                         //   const q15_t * pCoeffs,
                             (int16_t*) ptr3,                                //         q15_t * pState,
-                            (uint8_t)(n >> 8));                             //         int8_t postShift)
+                            (int8_t)n);                                     //         int8_t postShift)
 
                     } else //(RD(command,  COMMAND_SSRV) == SERV_DSP_RUN)
                     {
                         extern df1_q15 generic_biquad_cascade_df1_fast_q15;
                         generic_biquad_cascade_df1_fast_q15(                // void nanograph_filter_arm_biquad_cascade_df1_fast_q15(
-                            (const generic_biquad_cascade_df1_inst_q15*) ptr3, //   const arm_biquad_cascade_df1_inst_q15 * S,
-                            (const int16_t*) ptr1,                          //   const q15_t * pSrc,
-                            (int16_t*) ptr2,                                //         q15_t * pDst,
+                            (const generic_biquad_cascade_df1_inst_q15*) ptr1, //   const arm_biquad_cascade_df1_inst_q15 * S,
+                            (const int16_t*) ptr2,                          //   const q15_t * pSrc,
+                            (int16_t*) ptr3,                                //         q15_t * pDst,
                             (uint32_t)n);                                   //         uint32_t blockSize)
                     }
                 #endif
                 break;
-            case SERV_DSP_CASCADE_DF1_F32:          /* IIR filters arm_biquad_cascade_df1_f32*/
+            case SERV_DSP_CASCADE_DF1_F32:          /* IIR filters arm_biquad_cascade_df1_f32, multichannel */
               #ifdef PLATFORM_SERV_DSP_CASCADE_DF1_F32
                     if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
-                    {   //typedef void    (biquad_cascade_df1_f32_init) (
-                        //        biquad_cascade_df1_inst_f32 * S,
-                        //        uint8_t numStages,                n >> 8
-                        //  const int16_t * pCoeffs,
-                        //        int16_t * pState,
-                        //        int8_t postShift );               n & 0xFF
-                        platform_biquad_cascade_df1_init_f32((biquad_cascade_df1_inst_f32 *)ptr1, (uint8_t)(n >> 8), (uint16_t *)ptr2, (int16_t *)ptr3, (int8_t)n);
+                    {   extern df1_init_f32 platform_biquad_cascade_df1_init_f32;
+                        platform_biquad_cascade_df1_init_f32((generic_biquad_cascade_df1_inst_f32 *)ptr1, (uint8_t)(n >> 8), (uint8_t)n, (const float *)ptr2, (float *)ptr3);
 
                     } else //(RD(command,  COMMAND_SSRV) == SERV_RUN)
-                    {   //typedef void    (biquad_cascade_df1_f32) (
-                        //  const biquad_cascade_df1_inst_f32 * S,
-                        //  const int16_t * pSrc,
-                        //        int16_t * pDst,
-                        //        uint32_t blockSize );
-                        platform_biquad_cascade_df1_f32((biquad_cascade_df1_inst_q15 *)ptr1, (int16_t *)ptr2, (int16_t *)ptr3, (uint32_t)n);
+                    {   extern df1_f32 platform_biquad_cascade_df1_f32;
+                        platform_biquad_cascade_df1_f32((const generic_biquad_cascade_df1_inst_f32 *)ptr1, (const float *)ptr2, (float *)ptr3, (uint32_t)n);
                     }
                 #else
-                    //if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
-                    //{   extern df1_init_f32 generic_biquad_cascade_df1_init_f32;
-                    //    generic_biquad_cascade_df1_init_f32(                 // void arm_biquad_cascade_df1_init_f32(
-                    //        (generic_biquad_cascade_df1_inst_f32 *) ptr1,                   //         biquad_cascade_df1_inst_q15 * S,
-                    //        n & 0xFF,                                               //         uint8_t numStages,
-                    //        (const float *) ptr2,                                   //   const q15_t * pCoeffs,
-                    //        (float *) ptr3);                                        //         q15_t * pState)
-
-                    //} else //(RD(command,  COMMAND_SSRV) == SERV_DSP_RUN)
-                    //{   extern df1_f32 generic_biquad_cascade_df1_f32;
-                    //    generic_biquad_cascade_df1_f32(                     // void arm_biquad_cascade_df1_fast_f32(
-                    //        (const generic_biquad_cascade_df1_inst_f32 *) ptr3,             //   const arm_biquad_cascade_df1_inst_f32 * S,
-                    //        (const float *) ptr1,                                   //   const q15_t * pSrc,
-                    //        (float *) ptr2,                                         //         q15_t * pDst,
-                    //        (uint32_t)n);                                           //         uint32_t blockSize)
-                    //}
+                    if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                    {   extern df1_init_f32 generic_biquad_cascade_df1_init_f32;
+                        generic_biquad_cascade_df1_init_f32(                // void arm_biquad_cascade_df1_init_f32(
+                            (generic_biquad_cascade_df1_inst_f32 *) ptr1,   //         biquad_cascade_df1_inst_f32 * S,
+                            (uint8_t)(n >> 8),                              //         uint8_t numStages,
+                            (uint8_t)n,                                     //         uint8_t numChannels,
+                            (const float *) ptr2,                           //   const float32_t * pCoeffs,
+                            (float *) ptr3);                                //         float32_t * pState)
+
+                    } else //(RD(command,  COMMAND_SSRV) == SERV_DSP_RUN)
+                    {   extern df1_f32 generic_biquad_cascade_df1_f32;
+                        generic_biquad_cascade_df1_f32(                     // void arm_biquad_cascade_df1_f32(
+                            (const generic_biquad_cascade_df1_inst_f32 *) ptr1, //   const arm_biquad_cascade_df1_inst_f32 * S,
+                            (const float *) ptr2,                           //   const float32_t * pSrc,
+                            (float *) ptr3,                                 //         float32_t * pDst,
+                            (uint32_t)n);                                   //         uint32_t blockSize, per channel)
+                    }
                 #endif
+                break;
 
+            case SERV_DSP_CASCADE_DF2T_F32:         /* IIR filters arm_biquad_cascade_df2T_f32, multichannel */
+              #ifdef PLATFORM_SERV_DSP_CASCADE_DF2T_F32
+                    if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                    {   extern df1_init_f32 platform_biquad_cascade_df2T_init_f32;
+                        platform_biquad_cascade_df2T_init_f32((generic_biquad_cascade_df1_inst_f32 *)ptr1, (uint8_t)(n >> 8), (uint8_t)n, (const float *)ptr2, (float *)ptr3);
 
+                    } else //(RD(command,  COMMAND_SSRV) == SERV_RUN)
+                    {   extern df1_f32 platform_biquad_cascade_df2T_f32;
+                        platform_biquad_cascade_df2T_f32((const generic_biquad_cascade_df1_inst_f32 *)ptr1, (const float *)ptr2, (float *)ptr3, (uint32_t)n);
+                    }
+                #else
+                    if (RD(command,  COMMAND_SSRV) == SERV_DSP_INIT)
+                    {   extern df1_init_f32 generic_biquad_cascade_df2T_init_f32;
+                        generic_biquad_cascade_df2T_init_f32(               // void arm_biquad_cascade_df2T_init_f32(
+                            (generic_biquad_cascade_df1_inst_f32 *) ptr1,   //         biquad_cascade_df2T_instance_f32 * S,
+                            (uint8_t)(n >> 8),                              //         uint8_t numStages,
+                            (uint8_t)n,                                     //         uint8_t numChannels,
+                            (const float *) ptr2,                           //   const float32_t * pCoeffs,
+                            (float *) ptr3);                                //         float32_t * pState)
+
+                    } else //(RD(command,  COMMAND_SSRV) == SERV_DSP_RUN)
+                    {   extern df1_f32 generic_biquad_cascade_df2T_f32;
+                        generic_biquad_cascade_df2T_f32(                    // void arm_biquad_cascade_df2T_f32(
+                            (const generic_biquad_cascade_df1_inst_f32 *) ptr1, //   const arm_biquad_cascade_df2T_instance_f32 * S,
+                            (const float *) ptr2,                           //   const float32_t * pSrc,
+                            (float *) ptr3,                                 //         float32_t * pDst,
+                            (uint32_t)n);                                   //         uint32_t blockSize, per channel)
+                    }
+                #endif
                 break;
             /* ------------------------- */
             case 0:              
@@ -58,6 +58,39 @@ typedef void (*p_io_function_ctrl) (uint32_t command, nanograph_xdmbuffer_t *dat
 
 
 
+/* ------------------------------------------------------------------------------------------
+    IO acknowledge posted from an ISR, processed by the scheduler (NanoGraph_io_ack_post)
+*/
+typedef struct  
+{   void *data;
+    uintptr_t size;
+    uint8_t hwio_idx;
+} nanograph_io_ack_t;
+
+
+/* ------------------------------------------------------------------------------------------
+    segment of a frame spread over several buffers (NanoGraph_io_ackv)
+*/
+typedef struct  
+{   void *data;
+    uintptr_t size;
+} nanograph_io_segment_t;
+
+
+/* ------------------------------------------------------------------------------------------
+    IO event of the record files (IO_RECORD), followed by "size" bytes of data when "payload" is set
+*/
+typedef struct  
+{   uint64_t time64;                            // global_nanograph_time64, q32.28 [s]
+    uint32_t size;                              // bytes of the acknowledge or of the request
+    uint32_t hash;                              // FNV-1a of the data
+    uint8_t kind;                               // IO_EVENT_REQUEST, IO_EVENT_ACK, IO_EVENT_POST
+    uint8_t hwio_idx;                           // index of the IO in the platform
+    uint8_t payload;                            // the data follows the event
+    uint8_t reserved[5];                        // 24 bytes
+} nanograph_io_event_t;
+
+
 /* ------------------------------------------------------------------------------------------
     Stream instance memory
 */
@@ -76,7 +109,17 @@ typedef struct
     
     /* only in RAM section */
     uint32_t *all_formats;                      // indexed stream formats (can be changed by the nodes)
-    uint32_t *all_arcs;             
+    uint32_t *all_arcs;
+    uint32_t *arc_hot;                          // R/W indexes of the arcs (ARC_HOT_COLD_SPLIT)
+    uintptr_t *arc_base;                        // linear base address of the arc buffers
+    uint32_t *arc_extended;                     // 32-bit sizes and indexes of the arcs (ARC_EXTENDED)
+    uint32_t *arc_flow_errors;                  // overflow/underflow counters, SIZEOF_FLOWCNT_W32 words per arc
+    uint32_t *arc_watermarks;                   // occupancy watermarks of the arcs (PEAK_WMARK)
+    uint32_t *arc_time_stamps;                  // time-stamp rings of the arcs (ARC_TIMESTAMPS)
+    uint32_t *arc_staging;                      // staged RX data of the arcs (IO_COALESCING)
+    uint32_t *arc_drift;                        // drift estimators and resamplers of the arcs (IO_DRIFT_COMPENSATION)
+    uint8_t *arc_pool;                          // next free byte of the reserve pool (ARC_AUTO_GROW)
+    uint32_t arc_pool_free;                     // bytes left in the reserve pool
 
     /* working area of the graph interpreter */
     p_nanograph_node address_node;
@@ -94,6 +137,13 @@ typedef struct
     uint16_t idx_node;                          // index of the node to the flash
     /* NanoGraph_io_ack() is activated from the IO having an affinity with this instance/processor, no MP/cache issue */
     uint8_t ongoing_async_IO[MAX_IO_ONGOING_BYTES]; // asynchronous/slave IOs managed by this interpreter instance/processor
+    uint8_t io_flow_state[MAX_IO_FLOW_BYTES];   // back-pressure state of the commander IOs (BACKPRES_IOFMT1), written by the scheduler
+#ifdef IO_ACK_QUEUE
+    nanograph_io_ack_t io_ack_queue[IO_ACK_QUEUE]; // acknowledges posted by the ISRs, single producer
+    uint32_t io_ack_posted;                     // counters of posted/processed acknowledges, the slot 
+    uint32_t io_ack_drained;                    //   is counter % IO_ACK_QUEUE
+    uint32_t io_ack_overflow;                   // acknowledges dropped on a full queue, written by the ISRs
+#endif
     uint8_t node_memory_banks_offset;           // offset in words  
     uint8_t node_parameters_offset;             // 
     uint8_t main_script;                        // debug script common to all nodes, profiling, reads the use_case and global_opp
@@ -118,6 +168,16 @@ typedef struct
     p_nanograph_node node_entry_points;            // list of nodes
     p_io_function_ctrl platform_io;             // list of IO functions
     uintptr_t new_parameters;                   // list of [node index, parameter address]..[0;0]
+    uint32_t *arc_hot;                          // table of arc R/W indexes, SIZEOF_ARCHOT_W32 x MAX_NB_ARCS
+    uintptr_t *arc_base;                        // table of arc base addresses, MAX_NB_ARCS
+    uint32_t *arc_extended;                     // table of extended sizes and indexes, SIZEOF_ARCEXT_W32 x MAX_NB_ARCS
+    uint32_t *arc_flow_errors;                  // table of flow error counters, SIZEOF_FLOWCNT_W32 x MAX_NB_ARCS
+    uint32_t *arc_watermarks;                   // table of occupancy watermarks, MAX_NB_ARCS
+    uint32_t *arc_time_stamps;                  // table of time-stamp rings, SIZEOF_ARCTSTP_W32 x MAX_NB_ARCS
+    uint32_t *arc_staging;                      // table of RX staging states, SIZEOF_ARCSTG_W32 x MAX_NB_ARCS
+    uint32_t *arc_drift;                        // table of drift compensation states, SIZEOF_ARCDRIFT_W32 x MAX_NB_ARCS
+    uint8_t *arc_pool;                          // reserve pool of memory for the arcs growth
+    uint32_t arc_pool_size;                     // size of the reserve pool in bytes
     uint8_t procID;
     uint8_t archID;
 
@@ -32,10 +32,21 @@
 #include "../top_manifest_included.h"
 
 
+#if defined(PLATFORM_FILE_IO) || defined(PLATFORM_SHM_IO) || defined(IO_RECORD) || defined(IO_REPLAY)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
 #include "bsp_api.h"
 #include "common_data.h"
 FSP_HEADER
 FSP_FOOTER
+#endif
 
 
 #ifdef __cplusplus
@@ -46,6 +57,7 @@ FSP_FOOTER
 extern uint8_t one_file_is_closed;
 
 extern void NanoGraph_io_ack (uint8_t HW_io_idx, void *data, uintptr_t size);
+extern void NanoGraph_io_ack_post (uint8_t HW_io_idx, void *data, uintptr_t size);
 
 /*
  * NULL TASK
@@ -119,11 +131,491 @@ static uint32_t buffer_io_ui_out_0[size_io_ui_out_0 / sizeof(int32_t)];
 static uint32_t buffer_analog_in_0[size_analog_in_0 / sizeof(int32_t)];       
 
 #define size_audio_in_0 96                                                  // 23   microphone, PDM, line-in, modem, USB audio ("audio_in" domain)
-static uint32_t buffer_audio_in_0[size_audio_in_0 / sizeof(int32_t)];       
+static uint32_t buffer_audio_in_0[2 * size_audio_in_0 / sizeof(int32_t)];   //      ping-pong halves of the DMA
+static uint8_t flow_audio_in_0;                                             // IO_FLOW_xx back-pressure from the graph
+static uint32_t dma_fill_audio_in_0;                                        // bytes written by the DMA in its half
+static uint8_t dma_half_audio_in_0;                                         // half filled by the DMA, the graph owns the other
+
+#define size_2d_in_0 96                                                     // 30   camera ("2d_in" domain), one band of lines
+#define lines_2d_in_0 4                                                     //      lines per band (I2D_BANDS_FMT3)
+static uint32_t buffer_2d_in_0[2 * size_2d_in_0 / sizeof(int32_t)];         //      ping-pong bands
+static uint32_t fill_2d_in_0;                                               // bytes of lines received in the current band
+static uint8_t band_2d_in_0;                                                // band being filled, the other one is acknowledged
+
+
+
+#ifdef PLATFORM_FILE_IO
+/* --------------------------------------------------------------------------------------- 
+    HOST FILE IO : input files mapped in memory and read in place by the graph, output 
+    frames written to a file by a thread
+*/
+typedef struct 
+{   uint8_t *map;                   /* mapped file */
+    size_t map_size;
+    uint8_t *data;                  /* first sample (after the WAV header) */
+    uint32_t size;                  /* bytes of samples */
+    uint32_t position;              /* next frame given to the graph */
+} file_io_reader_t;
+
+typedef struct 
+{   FILE *file;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;            /* frames queued or written */
+    uint32_t queued, written;       /* frame counters, the slot is counter % FILE_IO_QUEUE */
+    uint8_t stop;
+    uint32_t size[FILE_IO_QUEUE];
+    uint8_t frame[FILE_IO_QUEUE][FILE_IO_FRAME_BYTES];
+} file_io_writer_t;
+
+static file_io_reader_t file_data_in_0;
+static file_io_writer_t file_data_out_0;
+
+
+/**
+  @brief        Map an input file, the samples of WAV files start after the "data" chunk header
+  @param[in]    name       file name
+  @param[out]   reader     mapped file
+  @return       0 when the file can't be mapped
+
+  @par          The mapping is private and writable : the graph may realign or clear data in 
+                its arc buffer without changing the file.
+ */
+static uint8_t file_io_map (const char *name, file_io_reader_t *reader)
+{   struct stat st;
+    uint32_t chunk, chunk_size;
+    int fd;
+
+    MEMSET(reader, 0, sizeof(file_io_reader_t))
+    fd = open(name, O_RDONLY);
+    if (fd < 0)
+    {   return 0;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {   close(fd);
+        return 0;
+    }
+    reader->map = (uint8_t *)mmap(0, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (reader->map == MAP_FAILED)
+    {   reader->map = 0;
+        return 0;
+    }
+    reader->map_size = (size_t)st.st_size;
+    reader->data = reader->map;
+    reader->size = (uint32_t)st.st_size;
+
+    /* RIFF/WAVE : skip the chunks until "data" */
+    if (reader->size >= 12 && 0 == memcmp(reader->map, "RIFF", 4) && 0 == memcmp(&(reader->map[8]), "WAVE", 4))
+    {   for (chunk = 12; chunk + 8 <= reader->size; chunk += 8 + chunk_size + (chunk_size & 1))
+        {   chunk_size = reader->map[chunk + 4] | (reader->map[chunk + 5] << 8) | 
+                (reader->map[chunk + 6] << 16) | ((uint32_t)reader->map[chunk + 7] << 24);
+            if (0 == memcmp(&(reader->map[chunk]), "data", 4))
+            {   reader->data = &(reader->map[chunk + 8]);
+                reader->size = MIN(chunk_size, reader->size - (chunk + 8));
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+
+/**
+  @brief        Writer thread of the output files, waits for the frames queued by the IO
+  @param[in]    arg        file_io_writer_t 
+  @return       0
+ */
+static void *file_io_writer_thread (void *arg)
+{   file_io_writer_t *writer = (file_io_writer_t *)arg;
+    uint32_t slot;
+
+    pthread_mutex_lock(&(writer->lock));
+    while (1)
+    {   while (writer->written == writer->queued && 0 == writer->stop)
+        {   pthread_cond_wait(&(writer->cond), &(writer->lock));
+        }
+        if (writer->written == writer->queued)
+        {   break;      /* stopped and all the frames written */
+        }
+        slot = writer->written % FILE_IO_QUEUE;
+        pthread_mutex_unlock(&(writer->lock));
+        fwrite(writer->frame[slot], 1, writer->size[slot], writer->file);
+        pthread_mutex_lock(&(writer->lock));
+        writer->written++;
+        pthread_cond_broadcast(&(writer->cond));
+    }
+    pthread_mutex_unlock(&(writer->lock));
+    return 0;
+}
+
+static uint8_t file_io_writer_open (const char *name, file_io_writer_t *writer)
+{
+    writer->file = fopen(name, "wb");
+    if (writer->file == 0)
+    {   return 0;
+    }
+    writer->queued = writer->written = 0;
+    writer->stop = 0;
+    pthread_mutex_init(&(writer->lock), 0);
+    pthread_cond_init(&(writer->cond), 0);
+    if (0 != pthread_create(&(writer->thread), 0, file_io_writer_thread, writer))
+    {   fclose(writer->file);
+        writer->file = 0;
+        return 0;
+    }
+    return 1;
+}
+
+static void file_io_writer_close (file_io_writer_t *writer)
+{
+    if (writer->file == 0)
+    {   return;
+    }
+    pthread_mutex_lock(&(writer->lock));
+    writer->stop = 1;
+    pthread_cond_broadcast(&(writer->cond));
+    pthread_mutex_unlock(&(writer->lock));
+    pthread_join(writer->thread, 0);
+    fclose(writer->file);
+    writer->file = 0;
+}
+#endif
+
+
+#ifdef PLATFORM_SHM_IO
+/* --------------------------------------------------------------------------------------- 
+    HOST SHARED-MEMORY IO : rings of frames shared with another process (shm_open)
+    
+    The other process opens the same name, maps sizeof(shm_io_ring_t) bytes and uses the 
+    free-running frame counters "write" and "read" with acquire/release ordering. 
+    io_data_in_1 : the process writes frame[write % nb_frames] then increments "write", the 
+        graph reads the frame in place and increments "read" when the frame is given back.
+    io_data_out_1 : the graph copies a frame and increments "write", the process reads the 
+        frame then increments "read".
+    The first side exchanging a null "magic" with SHM_IO_BUSY (compare-and-swap) clears the 
+    ring and sets "magic" last, the other side waits for SHM_IO_MAGIC and checks the geometry.
+*/
+#include <sched.h>
+#include <stdatomic.h>
+
+#define SHM_IO_MAGIC 0x4E475348u    /* "NGSH" */
+#define SHM_IO_BUSY  0x4E474249u    /* "NGBI" the ring is cleared by the other side */
+#define SHM_IO_OPEN_YIELDS 100000u  /* wait of the initialization by the other side */
+
+typedef struct 
+{   uint32_t magic;
+    uint32_t frame_bytes;           /* SHM_IO_FRAME_BYTES */
+    uint32_t nb_frames;             /* SHM_IO_FRAMES */
+    uint32_t write;                 /* frames written by the producer */
+    uint32_t read;                  /* frames released by the consumer */
+    uint32_t reserved[3];           /* 32 bytes header */
+    uint8_t frame[SHM_IO_FRAMES][SHM_IO_FRAME_BYTES];
+} shm_io_ring_t;
+
+typedef struct 
+{   shm_io_ring_t *ring;
+    uint32_t size;                  /* bytes requested by the graph */
+    uint8_t pending;                /* a request of the scheduler is waiting for the other process */
+    uint8_t held;                   /* io_data_in_1 : frame "read" is used in place by the graph */
+} shm_io_t;
+
+static shm_io_t shm_data_in_1;
+static shm_io_t shm_data_out_1;
+
+
+/**
+  @brief        Open or create a ring of frames in shared memory
+  @param[in]    name       POSIX shared-memory name
+  @param[out]   io         IO state
+  @return       0 when the ring can't be mapped, or has another geometry
 
-#define size_2d_in_0 96                                                     // 30   camera ("2d_in" domain)
-static uint32_t buffer_2d_in_0[size_2d_in_0 / sizeof(int32_t)];     
+  @par          A new object is sized by the first side, an object of another size is not 
+                resized. Only one side wins the compare-and-swap of the null magic and clears 
+                the ring, the other attaches once the magic is published.
+ */
+static uint8_t shm_io_open (const char *name, shm_io_t *io)
+{   shm_io_ring_t *ring;
+    struct stat st;
+    uint32_t expected, i;
+    int fd;
 
+    MEMSET(io, 0, sizeof(shm_io_t))
+    fd = shm_open(name, O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+    {   return 0;
+    }
+    if (0 != fstat(fd, &st) || (st.st_size != 0 && st.st_size != sizeof(shm_io_ring_t)) ||
+        0 != ftruncate(fd, sizeof(shm_io_ring_t)))
+    {   close(fd);
+        return 0;
+    }
+    ring = (shm_io_ring_t *)mmap(0, sizeof(shm_io_ring_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ring == MAP_FAILED)
+    {   return 0;
+    }
+
+    expected = 0;
+    if (atomic_compare_exchange_strong((volatile _Atomic uint32_t *)&(ring->magic), &expected, SHM_IO_BUSY))
+    {   ring->frame_bytes = SHM_IO_FRAME_BYTES;
+        ring->nb_frames = SHM_IO_FRAMES;
+        ring->write = ring->read = 0;
+        ARC_STORE_RELEASE(ring->magic, SHM_IO_MAGIC);
+    }
+    for (i = 0; i < SHM_IO_OPEN_YIELDS && SHM_IO_BUSY == ARC_LOAD_ACQUIRE(ring->magic); i++)
+    {   sched_yield();
+    }
+
+    /* attach : the ring is used only with the geometry of this side */
+    if (SHM_IO_MAGIC != ARC_LOAD_ACQUIRE(ring->magic) || 
+        ring->frame_bytes != SHM_IO_FRAME_BYTES || ring->nb_frames != SHM_IO_FRAMES)
+    {   munmap(ring, sizeof(shm_io_ring_t));
+        return 0;
+    }
+    io->ring = ring;
+    return 1;
+}
+
+static void shm_io_close (shm_io_t *io)
+{
+    if (io->ring != 0)
+    {   munmap(io->ring, sizeof(shm_io_ring_t));
+        io->ring = 0;
+    }
+}
+
+
+/**
+  @brief        Serve the pending requests of the graph with the frames of the other process
+  @return       number of acknowledged frames, the scheduler must be called when not null
+
+  @par          Called from io_data_in_1/io_data_out_1 on the request of the scheduler, and 
+                periodically by the application (test harness tick) while the other process 
+                is late. Without a free frame the request stays pending : the graph is not 
+                blocked and other IOs continue.
+ */
+uint32_t io_shm_poll (void)
+{   shm_io_ring_t *ring;
+    uint32_t write, read, slot, nack;
+
+    nack = 0;
+
+    ring = shm_data_in_1.ring;
+    if (ring != 0 && shm_data_in_1.pending)
+    {   write = ARC_LOAD_ACQUIRE(ring->write);
+        read = ring->read;
+        if (write - read > shm_data_in_1.held)
+        {   /* the frame used by the graph is given back with the acknowledge of the next one */
+            if (shm_data_in_1.held)
+            {   read = read + 1;
+                ARC_STORE_RELEASE(ring->read, read);
+            }
+            slot = read % SHM_IO_FRAMES;
+            shm_data_in_1.held = 1;
+            shm_data_in_1.pending = 0;
+            NanoGraph_io_ack (IO_PLATFORM_DATA_IN_1, ring->frame[slot], SHM_IO_FRAME_BYTES);
+            nack++;
+        }
+    }
+
+    ring = shm_data_out_1.ring;
+    if (ring != 0 && shm_data_out_1.pending)
+    {   write = ring->write;
+        read = ARC_LOAD_ACQUIRE(ring->read);
+        if (write - read < SHM_IO_FRAMES)
+        {   slot = write % SHM_IO_FRAMES;
+            shm_data_out_1.pending = 0;
+            NanoGraph_io_ack (IO_PLATFORM_DATA_OUT_1, ring->frame[slot], shm_data_out_1.size);
+            ARC_STORE_RELEASE(ring->write, write + 1);
+            nack++;
+        }
+    }
+    return nack;
+}
+#endif
+
+
+#if defined(IO_RECORD) || defined(IO_REPLAY)
+/* --------------------------------------------------------------------------------------- 
+    IO RECORD AND REPLAY : the file starts with IO_RECORD_MAGIC and sizeof(nanograph_io_event_t), 
+    then the events follow in time order, each one followed by its data when "payload" is set
+*/
+static uint32_t io_record_hash (const nanograph_io_segment_t *segment, uint32_t nb_segments)
+{   uint32_t hash = 0x811C9DC5u, iseg, i;
+    const uint8_t *pt8;
+
+    for (iseg = 0; iseg < nb_segments; iseg++)
+    {   pt8 = (const uint8_t *)(segment[iseg].data);
+        for (i = 0; i < segment[iseg].size; i++)
+        {   hash = (hash ^ pt8[i]) * 0x01000193u;
+        }
+    }
+    return hash;
+}
+#endif
+
+#ifdef IO_RECORD
+static FILE *io_record_file;
+
+static void io_record_close (void)
+{   if (io_record_file != 0)
+    {   fclose(io_record_file);
+        io_record_file = 0;
+    }
+}
+
+/**
+  @brief        Log of an IO event, see IO_RECORD_EVENT()
+  @param[in]    kind        IO_EVENT_REQUEST, IO_EVENT_ACK, IO_EVENT_POST
+  @param[in]    hwio_idx    index of the IO in the platform
+  @param[in]    segment     data of the event
+  @param[in]    nb_segments number of segments
+  @return       none
+
+  @par          The data of the acknowledges is logged with IO_RECORD_PAYLOAD : the RX data 
+                is replayed and the TX data is compared with the replay. The file is opened 
+                on the first event and closed at exit.
+ */
+void platform_io_record (uint8_t kind, uint8_t hwio_idx, const nanograph_io_segment_t *segment, uint32_t nb_segments)
+{   nanograph_io_event_t event;
+    uint32_t header[2], iseg;
+
+    if (io_record_file == 0)
+    {   io_record_file = fopen(FILE_IO_RECORD, "wb");
+        if (io_record_file == 0)
+        {   return;
+        }
+        header[0] = IO_RECORD_MAGIC;
+        header[1] = sizeof(nanograph_io_event_t);
+        fwrite(header, sizeof(header), 1, io_record_file);
+        atexit(io_record_close);
+    }
+
+    MEMSET(&event, 0, sizeof(event))
+    event.time64 = global_nanograph_time64;
+    event.kind = kind;
+    event.hwio_idx = hwio_idx;
+    for (iseg = 0; iseg < nb_segments; iseg++)
+    {   event.size += (uint32_t)(segment[iseg].size);
+    }
+    if (kind != IO_EVENT_REQUEST)
+    {   event.hash = io_record_hash(segment, nb_segments);
+        event.payload = IO_RECORD_PAYLOAD;
+    }
+    fwrite(&event, sizeof(event), 1, io_record_file);
+
+    if (event.payload)
+    {   for (iseg = 0; iseg < nb_segments; iseg++)
+        {   fwrite(segment[iseg].data, 1, segment[iseg].size, io_record_file);
+        }
+    }
+}
+#endif
+
+#ifdef IO_REPLAY
+static FILE *io_replay_file;
+static nanograph_io_event_t io_replay_event;            /* next event to replay */
+static uint8_t io_replay_pending;
+static uint64_t io_replay_t0_record, io_replay_t0;      /* time of the first event, and of its replay */
+static uint32_t io_replay_count;
+#ifdef IO_ACK_QUEUE
+#define IO_REPLAY_SLOTS IO_ACK_QUEUE
+#else
+#define IO_REPLAY_SLOTS 1                                /* the posted acknowledges are processed immediately */
+#endif
+static uint8_t io_replay_data[IO_REPLAY_SLOTS][IO_REPLAY_MAX_BYTES];  /* the posted data lives until drained */
+uint32_t io_replay_mismatch;                            /* acknowledges with a data hash different from the record */
+
+/* read of the next event and of its data */
+static uint8_t io_replay_read (void)
+{   uint8_t *data = io_replay_data[io_replay_count % IO_REPLAY_SLOTS];
+    uint32_t n;
+
+    if (1 != fread(&io_replay_event, sizeof(io_replay_event), 1, io_replay_file))
+    {   return 0;
+    }
+    MEMSET(data, 0, IO_REPLAY_MAX_BYTES)
+    if (io_replay_event.payload)
+    {   n = MIN(io_replay_event.size, IO_REPLAY_MAX_BYTES);
+        if (n != fread(data, 1, n, io_replay_file))
+        {   return 0;
+        }
+        fseek(io_replay_file, (long)(io_replay_event.size - n), SEEK_CUR);
+    }
+    io_replay_event.size = MIN(io_replay_event.size, IO_REPLAY_MAX_BYTES);
+    return 1;
+}
+
+/**
+  @brief        Replay of the recorded IO events
+  @param[in]    time64     current time, q32.28 [s]
+  @return       number of acknowledges replayed, the scheduler must be called when not null
+
+  @par          Called by the test harness on each tick in place of the IO drivers, the 
+                scheduler does not call the servant IOs (IO_REPLAY in check_graph_boundaries). 
+                The events are replayed at their time relative to the first one, or one by one 
+                as fast as possible with IO_REPLAY_FAST where global_nanograph_time64 is set to 
+                the time of the event. The data of TX acknowledges is compared with the record 
+                (io_replay_mismatch) when the payload was recorded. The end of the file sets 
+                one_file_is_closed.
+ */
+uint32_t io_replay_feed (uint64_t time64)
+{   uint32_t header[2], nack;
+    nanograph_io_segment_t segment;
+
+    if (io_replay_file == 0)
+    {   io_replay_file = fopen(FILE_IO_RECORD, "rb");
+        if (io_replay_file == 0 || 1 != fread(header, sizeof(header), 1, io_replay_file) || 
+            header[0] != IO_RECORD_MAGIC || header[1] != sizeof(nanograph_io_event_t) || 0 == io_replay_read())
+        {   one_file_is_closed = 1;
+            return 0;
+        }
+        io_replay_pending = 1;
+        io_replay_t0_record = io_replay_event.time64;
+        io_replay_t0 = time64;
+    }
+
+    for (nack = 0; io_replay_pending; )
+    {   if (IO_REPLAY_FAST)
+        {   if (nack > 0)
+            {   break;
+            }
+            global_nanograph_time64 = io_replay_event.time64;
+        }
+        else if (io_replay_event.time64 - io_replay_t0_record > time64 - io_replay_t0)
+        {   break;
+        }
+
+        segment.data = io_replay_data[io_replay_count % IO_REPLAY_SLOTS];
+        segment.size = io_replay_event.size;
+        switch (io_replay_event.kind)
+        {
+        case IO_EVENT_ACK:
+            NanoGraph_io_ack (io_replay_event.hwio_idx, segment.data, segment.size);
+            if (io_replay_event.payload && io_replay_event.hash != io_record_hash(&segment, 1))
+            {   io_replay_mismatch++;
+            }
+            nack++;
+            break;
+        case IO_EVENT_POST:
+            NanoGraph_io_ack_post (io_replay_event.hwio_idx, segment.data, segment.size);
+            nack++;
+            break;
+        default:    /* the requests are made again by the scheduler */
+            break;
+        }
+
+        io_replay_count++;
+        if (0 == io_replay_read())
+        {   io_replay_pending = 0;
+            one_file_is_closed = 1;
+            fclose(io_replay_file);
+        }
+    }
+    return nack;
+}
+#endif
 
 
 /*
@@ -138,7 +630,41 @@ void data_sink(uint32_t command, nanograph_xdmbuffer_t* data)
 
 void io_data_in_0(uint32_t command, nanograph_xdmbuffer_t* data)
 {
+#ifdef PLATFORM_FILE_IO
+    file_io_reader_t *reader = &file_data_in_0;
+
+    switch (command)
+    {
+    case NANOGRAPH_RESET:
+        if (0 == file_io_map(FILE_DATA_IN_0, reader))
+        {   one_file_is_closed = 1;
+        }
+        break;
+    case NANOGRAPH_SET_BUFFER:      /* the graph reads the frames in place */
+        if (reader->map != 0)       /* else no buffer, the graph is rejected (ERROR_LOG_IO_BUFFER) */
+        {   data->address = (intptr_t)reader->data;
+            data->size = FILE_IO_FRAME_BYTES;
+        }
+        break;
+    case NANOGRAPH_RUN:
+        if (reader->position + FILE_IO_FRAME_BYTES > reader->size)
+        {   one_file_is_closed = 1;     /* end of file, the last incomplete frame is not used */
+            break;
+        }
+        NanoGraph_io_ack (IO_PLATFORM_DATA_IN_0, &(reader->data[reader->position]), FILE_IO_FRAME_BYTES);
+        reader->position += FILE_IO_FRAME_BYTES;
+        break;
+    case NANOGRAPH_STOP:
+        if (reader->map != 0)
+        {   munmap(reader->map, reader->map_size);
+            reader->map = 0;
+        }
+        break;
+    default:
+        break;
     }
+#endif
+}
 
 /*
  * ---------------------IO_AL_idx = 2-----------------------------------
@@ -146,6 +672,29 @@ void io_data_in_0(uint32_t command, nanograph_xdmbuffer_t* data)
 
 void io_data_in_1(uint32_t command, nanograph_xdmbuffer_t* data)
 {
+#ifdef PLATFORM_SHM_IO
+    switch (command)
+    {
+    case NANOGRAPH_RESET:
+        shm_io_open(SHM_DATA_IN_1, &shm_data_in_1);
+        break;
+    case NANOGRAPH_SET_BUFFER:      /* the graph reads the frames in place in the ring */
+        if (shm_data_in_1.ring != 0)
+        {   data->address = (intptr_t)(shm_data_in_1.ring->frame[0]);
+            data->size = SHM_IO_FRAME_BYTES;
+        }
+        break;
+    case NANOGRAPH_RUN:
+        shm_data_in_1.pending = 1;
+        io_shm_poll();
+        break;
+    case NANOGRAPH_STOP:
+        shm_io_close(&shm_data_in_1);
+        break;
+    default:
+        break;
+    }
+#endif
 }
 
 
@@ -156,6 +705,46 @@ void io_data_in_1(uint32_t command, nanograph_xdmbuffer_t* data)
 
 void io_data_out_0(uint32_t command, nanograph_xdmbuffer_t* data)
 {
+#ifdef PLATFORM_FILE_IO
+    file_io_writer_t *writer = &file_data_out_0;
+    uint32_t slot, size;
+
+    switch (command)
+    {
+    case NANOGRAPH_RESET:
+        if (0 == file_io_writer_open(FILE_DATA_OUT_0, writer))
+        {   one_file_is_closed = 1;
+        }
+        break;
+    case NANOGRAPH_RUN:
+        if (writer->file == 0)
+        {   break;
+        }
+        /* wait for a free slot, then the graph copies its frame in it (io_set0copy1 1) */
+        pthread_mutex_lock(&(writer->lock));
+        while (writer->queued - writer->written >= FILE_IO_QUEUE)
+        {   pthread_cond_wait(&(writer->cond), &(writer->lock));
+        }
+        slot = writer->queued % FILE_IO_QUEUE;
+        pthread_mutex_unlock(&(writer->lock));
+
+        size = MIN((uint32_t)(data->size), FILE_IO_FRAME_BYTES);
+        NanoGraph_io_ack (IO_PLATFORM_DATA_OUT_0, writer->frame[slot], size);
+
+        pthread_mutex_lock(&(writer->lock));
+        writer->size[slot] = size;
+        writer->queued++;
+        pthread_cond_broadcast(&(writer->cond));
+        pthread_mutex_unlock(&(writer->lock));
+        break;
+    case NANOGRAPH_STOP:
+        file_io_writer_close(writer);
+        one_file_is_closed = 1;
+        break;
+    default:
+        break;
+    }
+#endif
 }
 
 /*
@@ -163,7 +752,25 @@ void io_data_out_0(uint32_t command, nanograph_xdmbuffer_t* data)
  */
 
 void io_data_out_1(uint32_t command, nanograph_xdmbuffer_t* data)
+{
+#ifdef PLATFORM_SHM_IO
+    switch (command)
     {
+    case NANOGRAPH_RESET:
+        shm_io_open(SHM_DATA_OUT_1, &shm_data_out_1);
+        break;
+    case NANOGRAPH_RUN:             /* the graph copies its frame in the ring (io_set0copy1 1) */
+        shm_data_out_1.size = MIN((uint32_t)(data->size), SHM_IO_FRAME_BYTES);
+        shm_data_out_1.pending = 1;
+        io_shm_poll();
+        break;
+    case NANOGRAPH_STOP:
+        shm_io_close(&shm_data_out_1);
+        break;
+    default:
+        break;
+    }
+#endif
 }
 
 /*
@@ -291,16 +898,20 @@ void io_audio_in_0 (uint32_t command, nanograph_xdmbuffer_t *data)      // micro
     case NANOGRAPH_SET_PARAMETER:
         break;
     case NANOGRAPH_SET_BUFFER:
-        {   pt_pt = (nanograph_xdmbuffer_t *)data;
-            pt_pt->address = (intptr_t)buffer_audio_in_0;
+        {   /* the graph starts with the empty second half, the DMA fills the first one */
+            pt_pt = (nanograph_xdmbuffer_t *)data;
+            pt_pt->address = (intptr_t)buffer_audio_in_0 + size_audio_in_0;
             pt_pt->size = size_audio_in_0;
+            dma_fill_audio_in_0 = 0;
+            dma_half_audio_in_0 = 0;
     }
     break;
+    case NANOGRAPH_FLOW_CONTROL:
+        flow_audio_in_0 = (uint8_t)(data->address);
+        break;
     case NANOGRAPH_RUN:
-        pt_pt = (nanograph_xdmbuffer_t*)data;
-        NanoGraph_io_ack (IO_PLATFORM_AUDIO_IN_0, buffer_audio_in_0, pt_pt->size);
+        break;          /* the DMA is free-running, see io_audio_in_0_dma() */
 
-        break;
     case NANOGRAPH_STOP:
         one_file_is_closed = 1;
         break;
@@ -310,6 +921,43 @@ void io_audio_in_0 (uint32_t command, nanograph_xdmbuffer_t *data)      // micro
 }
 
 
+/**
+  @brief        DMA emulation of audio_in_0 : circular transfer to the two halves of buffer_audio_in_0
+  @param[in]    src        samples received by the DMA since the last call
+  @param[in]    nbytes     amount of bytes
+  @return       none
+
+  @par          The half-transfer and transfer-complete interrupts are emulated with 
+                NanoGraph_io_ack_post() giving the half just filled : the graph processes it in place 
+                (io_set0copy1 0) while the DMA fills the other half. The graph must consume its half 
+                before the next interrupt, else NanoGraph_io_ack() counts an overflow in the flow 
+                error counter of the arc. The filled halves are dropped while the graph asks for 
+                IO_FLOW_PAUSE.
+  @remark       Called from the test harness at the sample rate of the stream.
+ */
+void io_audio_in_0_dma (const uint8_t *src, uint32_t nbytes)
+{   uint8_t *half;
+    uint32_t n;
+
+    while (nbytes > 0)
+    {   half = (uint8_t *)buffer_audio_in_0 + dma_half_audio_in_0 * size_audio_in_0;
+        n = MIN(nbytes, size_audio_in_0 - dma_fill_audio_in_0);
+        MEMCPY (&(half[dma_fill_audio_in_0]), src, n)
+        dma_fill_audio_in_0 += n;
+        src += n;
+        nbytes -= n;
+
+        if (dma_fill_audio_in_0 == size_audio_in_0)
+        {   dma_fill_audio_in_0 = 0;
+            dma_half_audio_in_0 ^= 1;
+            if (flow_audio_in_0 != IO_FLOW_PAUSE)
+            {   NanoGraph_io_ack_post (IO_PLATFORM_AUDIO_IN_0, half, size_audio_in_0);
+            }
+        }
+    }
+}
+
+
 /*
  * ---------------------IO_AL_idx = 26-----------------------------------
  */
@@ -324,4 +972,54 @@ void io_audio_out_0(uint32_t command, nanograph_xdmbuffer_t* data)           //
 
 void io_2d_in_0(uint32_t command, nanograph_xdmbuffer_t* data) 
 {
+    switch (command)
+    {
+    case NANOGRAPH_RESET:
+        fill_2d_in_0 = 0;
+        band_2d_in_0 = 0;
+        break;
+    case NANOGRAPH_RUN:
+        break;          /* the camera pushes its lines, see io_2d_in_0_line() */
+    case NANOGRAPH_STOP:
+        one_file_is_closed = 1;
+        break;
+    default:
+        break;
+    }
+}
+
+
+/**
+  @brief        Line interrupt of the camera : the lines are gathered in bands
+  @param[in]    src        pixels of the line
+  @param[in]    nbytes     bytes of the line, size_2d_in_0 / lines_2d_in_0 with the test camera
+  @return       none
+
+  @par          Each band of lines_2d_in_0 lines is posted with NanoGraph_io_ack_post() and 
+                copied to the arc (io_set0copy1 1), while the next band is received in the 
+                other half of buffer_2d_in_0. With a consumer frame size of one band the 2D 
+                nodes run on each band, the arc holds a few bands instead of a full image and 
+                the processing starts before the end of the image. The number of bands per 
+                image is given to the consumer in I2D_BANDS_FMT3. A line straddling two bands 
+                ends the band and its remaining pixels start the next one.
+  @remark       Called from the test harness at the line rate of the camera.
+ */
+void io_2d_in_0_line (const uint8_t *src, uint32_t nbytes)
+{   uint8_t *band;
+    uint32_t n;
+
+    while (nbytes > 0)
+    {   band = (uint8_t *)buffer_2d_in_0 + band_2d_in_0 * size_2d_in_0;
+        n = MIN(nbytes, size_2d_in_0 - fill_2d_in_0);
+        MEMCPY (&(band[fill_2d_in_0]), src, n)
+        fill_2d_in_0 += n;
+        src = src + n;
+        nbytes = nbytes - n;
+
+        if (fill_2d_in_0 == size_2d_in_0)
+        {   fill_2d_in_0 = 0;
+            band_2d_in_0 ^= 1;
+            NanoGraph_io_ack_post (IO_PLATFORM_2D_IN_0, band, size_2d_in_0);
+        }
+    }
 }
@@ -102,6 +102,48 @@ const uint8_t* long_offset[MAX_PROC_MEMBANK] =
 { &(MEXT[0]), &(DTCM[0]), &(ITCM[0]), &(BACKUP[0]) };
 
 
+/* linear base addresses of the arc buffers, the table is shared by the instances of this processor */
+uintptr_t arc_base_address[MAX_NB_ARCS];
+
+#ifdef ARC_HOT_COLD_SPLIT
+/* arc R/W indexes, one more cache line for the alignment made at reset */
+uint32_t arc_hot_indexes[SIZEOF_ARCHOT_W32 * MAX_NB_ARCS + CACHE_LINE_BYTE_LENGTH/4];
+#endif
+
+#ifdef ARC_EXTENDED
+/* 32-bit sizes and R/W indexes of the extended arcs (EXTDESC_ARCW3) */
+uint32_t arc_extended[SIZEOF_ARCEXT_W32 * MAX_NB_ARCS];
+#endif
+
+/* overflow/underflow counters of the arcs (OVERFLOW_FLOWCNT, UNDERFLOW_FLOWCNT), read by the application */
+uint32_t arc_flow_errors[SIZEOF_FLOWCNT_W32 * MAX_NB_ARCS];
+
+#ifdef ARC_WATERMARKS
+/* occupancy watermarks of the arcs (PEAK_WMARK, NEARFULL_WMARK) */
+uint32_t arc_watermarks[MAX_NB_ARCS];
+#endif
+
+#ifdef ARC_AUTO_GROW
+/* reserve pool of ARC_AUTO_GROW */
+uint32_t arc_reserve_pool[ARC_RESERVE_POOL_BYTES/4];
+#endif
+
+#ifdef ARC_TIMESTAMPS
+/* time-stamp rings of the arcs */
+uint32_t arc_time_stamps[SIZEOF_ARCTSTP_W32 * MAX_NB_ARCS];
+#endif
+
+#ifdef IO_COALESCING
+/* RX data staged in the arcs before publication */
+uint32_t arc_staging[SIZEOF_ARCSTG_W32 * MAX_NB_ARCS];
+#endif
+
+#ifdef IO_DRIFT_COMPENSATION
+/* clock drift estimators and resamplers of the IO arcs */
+uint32_t arc_drift[SIZEOF_ARCDRIFT_W32 * MAX_NB_ARCS];
+#endif
+
+
 uint8_t one_file_is_closed;         /* flag used to exit */
 
 /*---------------------------------------------------------
@@ -226,10 +268,12 @@ void platform_init_specific(NanoGraph_init_t* data)
         one_file_is_closed = 0;
     }
 
-    /* systick simulation */
+    /* systick simulation, VIRTUAL_TIME : the time is set by graph_test_virtual_time() */
+#ifndef VIRTUAL_TIME
     {   extern void SysTickSetup(void);
         SysTickSetup();
     }
+#endif
 #ifdef GRAPH_FROM_PLATFORM
     data->graph = get_graph_address(0);
 #endif
@@ -239,6 +283,30 @@ void platform_init_specific(NanoGraph_init_t* data)
     data->node_entry_points = (p_nanograph_node)node_entry_points;             // list of nodes
     data->platform_io = (p_io_function_ctrl)platform_io;                     // list of IO functions
     data->new_parameters = (uintptr_t)new_node_parameters;                   // list of pairs [offset; parameter address]
+#ifdef ARC_HOT_COLD_SPLIT
+    data->arc_hot = arc_hot_indexes;                                         // arc R/W indexes
+#endif
+    data->arc_base = arc_base_address;                                       // arc base addresses
+#ifdef ARC_EXTENDED
+    data->arc_extended = arc_extended;                                       // arc 32-bit sizes and indexes
+#endif
+    data->arc_flow_errors = arc_flow_errors;                                 // arc flow error counters
+#ifdef ARC_WATERMARKS
+    data->arc_watermarks = arc_watermarks;                                   // arc occupancy watermarks
+#endif
+#ifdef ARC_TIMESTAMPS
+    data->arc_time_stamps = arc_time_stamps;                                 // arc time-stamp rings
+#endif
+#ifdef IO_COALESCING
+    data->arc_staging = arc_staging;                                         // arc RX staging
+#endif
+#ifdef IO_DRIFT_COMPENSATION
+    data->arc_drift = arc_drift;                                             // arc clock drift compensation
+#endif
+#ifdef ARC_AUTO_GROW
+    data->arc_pool = (uint8_t *)arc_reserve_pool;                            // reserve pool for the arcs growth
+    data->arc_pool_size = ARC_RESERVE_POOL_BYTES;
+#endif
 
     data->procID = PLATFORM_PROCESSOR;
     data->archID = PLATFORM_ARCHITECTURE;
@@ -37,6 +37,19 @@
 //#define CACHE_LINE_BYTE_LENGTH 32       /* 32Bytes (CM7/CM55) */
 //#define CACHE_LINE_BYTE_LENGTH 64       /* 64bytes for Cortex-A armv8/v9 */
 
+//#define ARC_HOT_COLD_SPLIT              /* arc R/W indexes in a separate table, arc descriptors are read-only */
+#define MAX_NB_ARCS 32                  /* size of the tables of arc base addresses and R/W indexes */
+//#define ARC_EXTENDED                    /* arcs with 32-bit sizes and indexes (EXTDESC_ARCW3), 2D frames */
+//#define ARC_PLANAR                      /* arcs with FMT_DEINTERLEAVED_PLANAR consumers hold one plane per channel (PLANAR_ARCW4) */
+//#define ARC_WATERMARKS                  /* arc occupancy peaks and near-full counts, see NANOGRAPH_ARC_SIZING */
+//#define ARC_AUTO_GROW                   /* arcs often full are moved to a larger buffer of the reserve pool (needs ARC_WATERMARKS) */
+#define ARC_RESERVE_POOL_BYTES 1024     /* reserve pool of ARC_AUTO_GROW */
+//#define ARC_TIMESTAMPS                  /* time-stamps of the IO frames of time-stamped arcs (TIMSTAMP_FMT1), in a ring per arc */
+#define ARC_TSTP_RING 4                 /* frames per ring of ARC_TIMESTAMPS, power of 2 */
+//#define IO_FORMAT_CONVERSION            /* conversion of the IO samples in the data copy (IORAW_IOFMT1) */
+//#define IO_DRIFT_COMPENSATION           /* resampling of the IO streams on independent clocks (DRIFTCOMP_IOFMT1) */
+//#define IO_COALESCING                   /* RX acknowledges staged in the arc until a consumer frame is complete (COALESCE_IOFMT1), with IO_ACK_QUEUE */
+
 /*
  * --- maximum number of processors using STREAM in parallel - read by the graph compiler
  */
@@ -95,6 +108,42 @@
 
 #define MAX_NBGRAPHIO (1 + IO_PLATFORM_2D_OUT_1)
 
+#define IO_ACK_QUEUE 16                 /* acknowledges posted by the ISRs with NanoGraph_io_ack_post(), power of 2, else processed in the ISR */
+
+//#define PLATFORM_FILE_IO                /* host : io_data_in_0 maps a raw/WAV file, io_data_out_0 has a writer thread */
+#define FILE_DATA_IN_0  "data_in_0.wav" /* raw or WAV file read in place by the graph (io_set0copy1 0) */
+#define FILE_DATA_OUT_0 "data_out_0.raw"
+#define FILE_IO_FRAME_BYTES 256         /* frames of io_data_in_0, and largest frame of io_data_out_0 */
+#define FILE_IO_QUEUE 8                 /* frames queued for the writer thread of io_data_out_0 */
+
+//#define IO_RECORD                       /* host : the IO events are logged to FILE_IO_RECORD (platform_io_record) */
+//#define IO_REPLAY                       /* host : the IO events of FILE_IO_RECORD replace the IO drivers (io_replay_feed) */
+#define FILE_IO_RECORD "io_record.bin"
+#define IO_RECORD_PAYLOAD 1             /* 1 : the data of the acknowledges is logged, 0 : its hash only */
+#define IO_REPLAY_FAST 0                /* 1 : the events are replayed as fast as possible, 0 : at their relative times */
+#define IO_REPLAY_MAX_BYTES 4096        /* largest acknowledge replayed */
+
+//#define VIRTUAL_TIME                    /* host : no systick, the time jumps to the next IO frame (graph_test_virtual_time) */
+//#define BENCHMARK_DF1_Q15               /* host : graph_test_benchmark_df1_q15() prints the time of the biquad service */
+//#define TEST_BIQUAD_F32                 /* host : graph_test_biquad_f32() checks the float DF1 and DF2T biquads against a scalar reference */
+//#define BENCHMARK_ARC_ACCESS            /* host : graph_test_benchmark_arc_access() prints the time of the IO acknowledges */
+//#define STRESS_ARC_SPSC                 /* host : graph_test_stress_arc_spsc() checks an arc shared by two threads (pthread) */
+//#define TEST_ARC_HISTORY                /* host : graph_test_arc_history() checks the history kept before the read index */
+//#define STRESS_DMA_PINGPONG             /* host : graph_test_stress_dma_pingpong() checks the halves of the audio_in_0 DMA (pthread) */
+//#define BENCHMARK_IO_ACK_POST           /* host : graph_test_benchmark_io_ack_post() prints the time of io_ack and io_ack_post (pthread) */
+//#define TEST_DRIFT_HOUR                 /* host : graph_test_drift_hour() resamples one hour of a stream drifting by 100ppm (IO_DRIFT_COMPENSATION) */
+//#define TEST_SHM_IO                     /* host : graph_test_shm_io() checks the shared-memory rings of io_data_in_1/io_data_out_1 (PLATFORM_SHM_IO) */
+//#define TEST_IO_CONVERSION              /* host : graph_test_io_conversion() checks the IO sample conversions (IO_FORMAT_CONVERSION) */
+//#define TEST_ARC_PLANAR                 /* host : graph_test_arc_planar() makes a 3-channel round trip through a planar arc (ARC_PLANAR) */
+//#define TEST_2D_BANDS                   /* host : graph_test_2d_bands() consumes the bands of lines of io_2d_in_0 (I2D_BANDS_FMT3) */
+//#define TEST_IO_COALESCING              /* host : graph_test_io_coalescing() reaches the end of the arc with staged RX data (IO_COALESCING) */
+
+//#define PLATFORM_SHM_IO                 /* host : io_data_in_1/io_data_out_1 exchange frames with another process */
+#define SHM_DATA_IN_1  "/nanograph_data_in_1"   /* POSIX shared-memory rings (shm_io_ring_t) */
+#define SHM_DATA_OUT_1 "/nanograph_data_out_1"
+#define SHM_IO_FRAME_BYTES 256          /* frame size of the rings, same as the graph IO frames */
+#define SHM_IO_FRAMES 16                /* frames in each ring */
+
 //#define LAST_IO_FUNCTION_PLATFORM (IO_PLATFORM_DATA_OUT_0+1)  /* table of platform_io[io_al_idx] */
 
 //#define MAX_IO_FUNCTION_PLATFORM 128     /* table of platform_io[io_al_idx] */
@@ -167,9 +216,12 @@
     //#undef PLATFORM_SERV_SERV_DFT_Q15              /* DFT/Goertzel windowing, module, dB */
     //#undef PLATFORM_SERV_SERV_DFT_F32            
 
+#if defined(__ARM_ARCH)
     #define PLATFORM_SERV_DSP_CASCADE_DF1_Q15           /* IIR filters, use SERV_CHECK_COPROCESSOR */
+#endif                                                  /* host : generic_biquad_cascade_df1_fast_q15, vector lanes */
 #define PLATFORM_SERV_DSP_CASCADE_DF1_Q15_ESS       /*  error spectral shaping */          
     //#define PLATFORM_SERV_DSP_CASCADE_DF1_F32         /* take the default implementation */
+    //#define PLATFORM_SERV_DSP_CASCADE_DF2T_F32        /* take the default implementation */
 
     //#undef PLATFORM_SERV_SERV_WINDOW                
     //#undef PLATFORM_SERV_SERV_WINDOW_DB             
@@ -221,6 +273,28 @@
 #endif
 
 
+/*
+    arc index protocol (nanograph_const.h) : acquire after the load of the index of the other side,
+    release before the store of its own index. Cortex-M85 : DMB, with the compiler barrier for the ISRs.
+    Without these barriers the host compilation uses C11 atomics.
+ */
+/*
+    time of the IO frames (ARC_TIMESTAMPS) and IO coalescing timeouts (IO_COALESCING) : 
+    q12.20 [s] taken from "global_nanograph_time64" (q32.28), also the time of the recorded 
+    IO events (IO_RECORD) and of the simulations in virtual time (VIRTUAL_TIME)
+ */
+#if defined(ARC_TIMESTAMPS) || defined(IO_COALESCING) || defined(IO_RECORD) || defined(IO_REPLAY) || defined(VIRTUAL_TIME)
+#include <stdint.h>
+extern uint64_t global_nanograph_time64;
+#define ARC_TIME_STAMP_NOW() ((uint32_t)(global_nanograph_time64 >> 8))
+#endif
+
+#if defined(__ARM_ARCH)
+#define ARC_ACQUIRE_BARRIER __asm volatile ("dmb 0xF" ::: "memory")
+#define ARC_RELEASE_BARRIER __asm volatile ("dmb 0xF" ::: "memory")
+#endif
+
+
 #define WR_BYTE_MP_(address,x) { *(volatile uint8_t *)(address) = (x); DATA_MEMORY_BARRIER; }
 #define RD_BYTE_MP_(x,address) { DATA_MEMORY_BARRIER; (x) = *(volatile uint8_t *)(address);}
 #define CLEAR_BIT_MP(arg, bit) {((arg) = U(arg) & U(~(U(1) << U(bit)))); DATA_MEMORY_BARRIER; } 
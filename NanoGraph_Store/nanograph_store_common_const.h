@@ -46,6 +46,17 @@
 #define NODE_TASKS_NOT_COMPLETED 1u
 
 #define MAX_NB_NANOGRAPH_PER_NODE 8        /* I/O streams per node, see graph "NBARCW_LW0" */
+#define MAX_NB_PLANAR_CHANNELS 8        /* channels of planar arcs given with one pointer per channel */
+
+/* message arcs : records of [header][time-stamp][payload padded to 4 bytes], see nanograph_msg_push() */
+#define MSG_HEADER_BYTES 8u             /* header and time-stamp words */
+#define MSG_RECORD_BYTES(length) (MSG_HEADER_BYTES + (((length) + 3u) & ~3u))
+#define    unused_MSGH_MSB 31u 
+#define    unused_MSGH_LSB 24u /*  8  */
+#define       TAG_MSGH_MSB 23u 
+#define       TAG_MSGH_LSB 16u /*  8  message type chosen by the producer */
+#define    LENGTH_MSGH_MSB 15u 
+#define    LENGTH_MSGH_LSB  0u /* 16  payload length in bytes */
 
 
 
@@ -105,6 +116,7 @@
 #define FMT_INTERLEAVED 0u          /* "arc_descriptor_interleaved" for example L/R audio or IMU stream..   */
 #define FMT_DEINTERLEAVED_1PTR 1u   /* pointer to the first channel, next base address is frame size/nchan */
 #define FMT_DEINTERLEAVED_UNPACK 2u /* audioreach de-interleaved unpack : LLLL__ RRRR__ using two buffers */
+#define FMT_DEINTERLEAVED_PLANAR 3u /* one aligned plane per channel, the node receives a table of channel pointers (ARC_PLANAR) */
 
 //enum direction_rxtx {
 #define IODIRECTION_RX 0u          /* RX from the Graph pont of view */
@@ -174,8 +186,8 @@
     /* framesize; same comment for the sampling rate.                                       */
     /* The frameSize is including the time-stamp field                                      */
 
-    #define unused____FMT0_MSB  31u /*  8 reserved */
-    #define unused____FMT0_LSB  24u 
+    #define   HISTORY_FMT0_MSB  31u /*  8 consumer format : number of past samples (per channel) kept valid */
+    #define   HISTORY_FMT0_LSB  24u /*    before the read index, the arc buffer is extended by this amount */
     #define FRAMESIZE_FMT0_MSB  SIZE_EXT_FMT0_MSB
     #define FRAMESIZE_FMT0_LSB  SIZE_EXT_FMT0_LSB
 
@@ -241,8 +253,10 @@
         R2D_TBD=0, R2D_1_1=1, R2D_4_3=2, R2D_16_9=3, R2D_3_2=4 
     }   ratio_2d_fmt3 ;
 
-    #define   unused_____FMT3_MSB U(31) /* 14 */
-    #define   unused_____FMT3_LSB U(18)
+    #define   unused_____FMT3_MSB U(31) /*  6 */
+    #define   unused_____FMT3_LSB U(26)
+    #define    I2D_BANDS_FMT3_MSB U(25) /*  8 line-band streaming : bands of lines per image, 0 = full images */
+    #define    I2D_BANDS_FMT3_LSB U(18) /*    the frame size is one band, the consumer counts the bands of the image */
     #define   I2D_BORDER_FMT3_MSB U(17) /*  2 pixel border 0,1,2,3   */
     #define   I2D_BORDER_FMT3_LSB U(16)
     #define I2D_VERTICAL_FMT3_MSB U(15) /*  1 set to 0 for horizontal, 1 for vertical */
@@ -327,6 +341,11 @@
 
     #define NANOGRAPH_LIBRARY          10u  /* other functions of the node (IIR parameters compute, ..) */
     #define NANOGRAPH_SET_USE_CASE_OPP 11u  /* update operation performance point and use-case */
+    #define NANOGRAPH_ARC_SIZING       12u  /* arm_graph_interpreter(NANOGRAPH_ARC_SIZING, instance, *sizes, narc) recommended BUFF_SIZE */
+    #define NANOGRAPH_FLOW_CONTROL     13u  /* platform_IO(NANOGRAPH_FLOW_CONTROL, *data) back-pressure to commander IOs  */
+        #define IO_FLOW_RESUME        0u  /*   data->address = IO_FLOW_xx, data->size = amount of data in the arc */
+        #define IO_FLOW_SLOWDOWN      1u  /*   the arc is half full */
+        #define IO_FLOW_PAUSE         2u  /*   the arc is 3/4 full, resume when 1/4 full */
 
     #define NOWAIT_OPTION_SSRV      0u   /* OPTION_SSRV  stall or not the COMMAND */
     #define   WAIT_OPTION_SSRV      1u
@@ -695,7 +714,8 @@
     #define SERV_DSP_DFT_Q15            9u   /* DFT/Goertzel windowing, module, dB */
     #define SERV_DSP_DFT_F32            10u
     #define SERV_DSP_CASCADE_DF1_Q15    3u   /* IIR filters, use SERV_CHECK_COPROCESSOR */
-    #define SERV_DSP_CASCADE_DF1_F32    4u         
+    #define SERV_DSP_CASCADE_DF1_F32    4u   /* multichannel, interleaved samples */
+    #define SERV_DSP_CASCADE_DF2T_F32   11u  /* transposed DF2, multichannel, interleaved samples */
 
             /* COMMAND_SSRV */
     #define SERV_DSP_RUN                0u   /* run = default */
@@ -52,6 +52,70 @@ struct nanograph_xdmbuffer
 typedef struct nanograph_xdmbuffer nanograph_xdmbuffer_t;
 
 
+/* ------------------------------------------------------------------------------------------
+    frame time-stamps (ARC_TIMESTAMPS) : the xdm_data[] given to the node are followed by the 
+    time-stamp of the IO frame holding the first byte to read on each time-stamped input arc 
+    (TIMSTAMP_FMT1), and the distance in bytes from the start of this frame to the read index.
+    The node converts the distance to samples for a sample-accurate time of its first sample.
+*/
+typedef struct
+{   nanograph_xdmbuffer_t xdm[MAX_NB_NANOGRAPH_PER_NODE];
+    uint32_t time_stamp[MAX_NB_NANOGRAPH_PER_NODE];     /* q12.20 [s] or frame index (FRAME_COUNTER) */
+    uint32_t time_offset[MAX_NB_NANOGRAPH_PER_NODE];    /* bytes from the frame start to the read index */
+} nanograph_xdm_frame_t;
+
+static inline uint32_t nanograph_frame_time_stamp (void *xdm_data, uint32_t iarc, uint32_t *offset)
+{   nanograph_xdm_frame_t *frame = (nanograph_xdm_frame_t *)xdm_data;
+    *offset = frame->time_offset[iarc];
+    return frame->time_stamp[iarc];
+}
+
+
+/* ------------------------------------------------------------------------------------------
+    message arcs (MESSAGE_ARCW4) : non-blocking push/pop of length-prefixed records
+      the node keeps the amount of bytes pushed/popped in "used" and returns it in xdm->size 
+      at the end of its execution, a record is popped only when all its bytes are readable
+*/
+static inline uint8_t nanograph_msg_push (nanograph_xdmbuffer_t *xdm, uint32_t *used, 
+    uint8_t tag, uint32_t time_stamp, const uint8_t *payload, uint32_t length)
+{
+    uint32_t *record;
+
+    if ((intptr_t)(*used + MSG_RECORD_BYTES(length)) > xdm->size)
+    {   return 0;                   /* no room : the message is not pushed */
+    }
+    record = (uint32_t *)(xdm->address + *used);
+    record[0] = 0;
+    ST(record[0], TAG_MSGH, tag);
+    ST(record[0], LENGTH_MSGH, length);
+    record[1] = time_stamp;
+    MEMCPY((uint8_t *)&(record[2]), payload, length);
+    *used = *used + MSG_RECORD_BYTES(length);
+    return 1;
+}
+
+static inline uint8_t nanograph_msg_pop (nanograph_xdmbuffer_t *xdm, uint32_t *used, 
+    uint8_t *tag, uint32_t *time_stamp, uint8_t *payload, uint32_t *length)
+{
+    uint32_t *record, msg_length;
+
+    if ((intptr_t)(*used + MSG_HEADER_BYTES) > xdm->size)
+    {   return 0;                   /* no message */
+    }
+    record = (uint32_t *)(xdm->address + *used);
+    msg_length = RD(record[0], LENGTH_MSGH);
+    if ((intptr_t)MSG_RECORD_BYTES(msg_length) > xdm->size - (intptr_t)(*used))
+    {   return 0;                   /* the payload is not in the readable data */
+    }
+    *tag = (uint8_t)RD(record[0], TAG_MSGH);
+    *time_stamp = record[1];
+    MEMCPY(payload, (uint8_t *)&(record[2]), MIN(msg_length, *length));   /* truncated to the buffer size */
+    *length = msg_length;
+    *used = *used + MSG_RECORD_BYTES(msg_length);
+    return 1;
+}
+
+
 
 /* ------------------------------------------------------------------------------------------
     stream services
@@ -153,24 +217,27 @@ typedef void (*p_nanograph_services_t) (uint32_t service_command, intptr_t ptr1,
             uint32_t blockSize );
 
     //#define SERV_DSP_CASCADE_DF1_F32
-    //use #define PLATFORM_SERV_DSP_CASCADE_DF1_F32 for specific implmentations
-    typedef struct
+    //#define SERV_DSP_CASCADE_DF2T_F32
+    //use #define PLATFORM_SERV_DSP_CASCADE_DF1_F32 and PLATFORM_SERV_DSP_CASCADE_DF2T_F32 for specific implmentations
+    typedef struct                  /* DF1 and DF2T, the channels share the coefficients */
     {       uint32_t numStages;
-            float *pState;
-      const float *pCoeffs;
+            float *pState;          /* [stage][4 DF1 or 2 DF2T][channel] */
+      const float *pCoeffs;         /* {b0, b1, b2, a1, a2} per stage, a1 a2 negated */
+            uint32_t numChannels;   /* interleaved samples */
     } generic_biquad_cascade_df1_inst_f32;
 
-    typedef void (df1_init_f32) (
+    typedef void (df1_init_f32) (   /* also the DF2T template */
         generic_biquad_cascade_df1_inst_f32 * S,
           uint8_t numStages,
+          uint8_t numChannels,
     const float * pCoeffs,
           float * pState);
 
-    typedef void (df1_f32) (        /* platform-accelerated DF1 will use this template */
+    typedef void (df1_f32) (        /* platform-accelerated DF1 will use this template, also DF2T */
     const generic_biquad_cascade_df1_inst_f32 * S,
     const float * pSrc,
           float * pDst,
-          uint32_t blockSize);
+          uint32_t blockSize);      /* samples per channel */
 
 
     //#define SERV_DSP_WINDOW                
@@ -29,6 +29,7 @@
 #include "top_manifest_included.h"
 #include "nanograph_common.h"
 #include "nanograph_interpreter.h"
+#include "Integration/graph_test.h"
 
 
 
@@ -121,6 +122,46 @@ void main_init(uint32_t *graph)
 
     /* reset the graph */
     nanograph_interpreter(NANOGRAPH_RESET, &my_instance, 0, 0); // platform_callbacks, platform_services_bits);
+
+#ifdef BENCHMARK_DF1_Q15
+    graph_test_benchmark_df1_q15();
+#endif
+#ifdef TEST_BIQUAD_F32
+    graph_test_biquad_f32();
+#endif
+#ifdef BENCHMARK_ARC_ACCESS
+    graph_test_benchmark_arc_access();
+#endif
+#ifdef STRESS_ARC_SPSC
+    graph_test_stress_arc_spsc();
+#endif
+#ifdef TEST_ARC_HISTORY
+    graph_test_arc_history();
+#endif
+#ifdef STRESS_DMA_PINGPONG
+    graph_test_stress_dma_pingpong();
+#endif
+#if defined(BENCHMARK_IO_ACK_POST) && defined(IO_ACK_QUEUE)
+    graph_test_benchmark_io_ack_post();
+#endif
+#if defined(TEST_DRIFT_HOUR) && defined(IO_DRIFT_COMPENSATION)
+    graph_test_drift_hour();
+#endif
+#if defined(TEST_SHM_IO) && defined(PLATFORM_SHM_IO)
+    graph_test_shm_io();
+#endif
+#if defined(TEST_IO_CONVERSION) && defined(IO_FORMAT_CONVERSION)
+    graph_test_io_conversion();
+#endif
+#if defined(TEST_ARC_PLANAR) && defined(ARC_PLANAR)
+    graph_test_arc_planar();
+#endif
+#ifdef TEST_2D_BANDS
+    graph_test_2d_bands();
+#endif
+#if defined(TEST_IO_COALESCING) && defined(IO_COALESCING)
+    graph_test_io_coalescing();
+#endif
 }
 
 
@@ -163,11 +204,21 @@ void main_run(void)
     {   //arm_memory_swap(&(instance[NANOGRAPH_CURRENT_INSTANCE]));
     }
 
+#ifdef VIRTUAL_TIME                 /* the first call runs the simulation, graph_test_virtual_time() calls the scheduler */
+    {   static uint8_t virtual_time_started;
+
+        if (0 == virtual_time_started)
+        {   virtual_time_started = 1;
+            graph_test_virtual_time();
+            return;
+        }
+    }
+#else
     {
         extern uint64_t graph_interpreter_time64; 
-        extern void graph_test_scheduler(uint64_t time64);
         graph_test_scheduler(graph_interpreter_time64);
     }
+#endif
 
     nanograph_interpreter (NANOGRAPH_RUN, &my_instance, 0, 0);
 